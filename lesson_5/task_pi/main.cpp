@@ -19,14 +19,15 @@ int main(int argc, char* argv[]) {
 
   parallel::Broadcast(N, MPI_INT);
 
-  double part_of_pi;
+  int begin, end;
+  parallel::BalancedRange(N, ranks_amount, curr_rank, begin, end);
 
-  part_of_pi = PartOfPi(N, curr_rank * (N / ranks_amount),
-                        (curr_rank + 1) * (N / ranks_amount));
+  // точная сумма: результат не зависит от числа процессов
+  ReproducibleSum part_of_pi = ReproduciblePartOfPi(N, begin, end);
 
   double pi = 0;
 
-  parallel::Operation(part_of_pi, pi, MPI_DOUBLE, MPI_SUM);
+  parallel::Operation(part_of_pi, pi);
 
   if (curr_rank == 0) std::cout << "Pi: " << pi << std::endl;
 
@@ -35,80 +35,58 @@ int main(int argc, char *argv[]) {
   int end_j = 1 + (curr_rank + 1) * (N - 1) / ranks_amount;
   int N_curr_rank = end_j - beg_j + 1;
 
-  std::vector<double> U(N_curr_rank + 1, 0.0);
-  std::vector<double> U_new(N_curr_rank + 1, 0.0);
-  std::vector<double> U_all;
+  // общие массивы держат окна MPI, поэтому освобождаются до Finalize
+  {
+    // U и U_new лежат в общей памяти узла: соседи на том же узле читают края
+    // напрямую, по сети передаются только границы между узлами
+    parallel::SharedArray<double> U(N_curr_rank + 1);
+    parallel::SharedArray<double> U_new(N_curr_rank + 1);
 
-  if (curr_rank == 0) {
-    U_all.resize(N + 1, 0.0);
-
-    U_all[0] = 1.0;
-    U_all[N] = 0.0;
+    for (int i = 0; i <= N_curr_rank; i++) U[i] = U_new[i] = 0.0;
 
-    U[0] = U_new[0] = 1.0;
-  }
+    if (curr_rank == 0) U[0] = U_new[0] = 1.0;
 
-  for (;; count++) {
-    delta_max_j = 0.0;
+    // невязка шага k сводится неблокирующе, пока считается шаг k + 1
+    parallel::Request delta_request;
+    double delta_max_sent;
 
-    for (int i = 1; i < N_curr_rank; i++) {
-      U_new[i] = U[i] + (tau / (h * h)) * (U[i - 1] - 2 * U[i] + U[i + 1]);
+    for (;; count++) {
+      delta_max_j = 0.0;
 
-      delta_max_j = std::fmax(delta_max_j, std::fabs(U_new[i] - U[i]));
-    }
+      for (int i = 1; i < N_curr_rank; i++) {
+        U_new[i] = U[i] + (tau / (h * h)) * (U[i - 1] - 2 * U[i] + U[i + 1]);
 
-    parallel::Operation(delta_max_j, delta_max_all, MPI_DOUBLE, MPI_MAX);
-    parallel::Broadcast(delta_max_all, MPI_DOUBLE);
+        delta_max_j = std::fmax(delta_max_j, std::fabs(U_new[i] - U[i]));
+      }
 
-    if (delta_max_all < epsilon) break;
+      if (!delta_request.IsNull()) {
+        delta_request.Wait();
 
-    if (curr_rank > 0) {
-      parallel::Send(U_new[1], MPI_DOUBLE, curr_rank - 1);
+        // сошёлся предыдущий шаг: его результат в U, текущий шаг лишний
+        if (delta_max_all < epsilon) {
+          std::swap(U, U_new);
+          break;
+        }
+      }
 
-      parallel::ReceiveIgnoreStatus(U_new[0], MPI_DOUBLE, curr_rank - 1);
-    }
+      delta_max_sent = delta_max_j;
+      delta_request = parallel::IAllOperation(delta_max_sent, delta_max_all,
+                                              MPI_DOUBLE, MPI_MAX);
 
-    if (curr_rank < ranks_amount - 1) {
-      parallel::Send(U_new[N_curr_rank - 1], MPI_DOUBLE, curr_rank + 1);
+      parallel::ShiftHalo(U_new, MPI_DOUBLE);
 
-      parallel::ReceiveIgnoreStatus(U_new[N_curr_rank], MPI_DOUBLE,
-                                    curr_rank + 1);
+      std::swap(U, U_new);
     }
 
-    U = U_new;
-  }
-
-  int N_rank_number = N_curr_rank - 1;
+    // каждый процесс пишет свои внутренние точки сам, крайние процессы -
+    // вместе с граничными
+    int write_beg = curr_rank == 0 ? 0 : 1;
+    int write_end =
+        curr_rank == ranks_amount - 1 ? N_curr_rank : N_curr_rank - 1;
 
-  if (curr_rank == 0) {
-    std::vector<int> counts(ranks_amount);
-    parallel::Gather(&N_rank_number, 1, MPI_INT, counts.data(), 1, MPI_INT);
-
-    std::vector<int> displacements(ranks_amount);
-
-    for (int i = 0; i < ranks_amount - 1; i++) {
-      if (i == 0) displacements[i] = 0;
-      displacements[i + 1] = displacements[i] + counts[i];
-    }
-
-    parallel::GatherVarious(&U_new[1], MPI_DOUBLE, &U_all[1], MPI_DOUBLE,
-                            counts.data(), displacements.data(), N_rank_number);
-    // parallel::GatherVarious(U_new.data() + 1, MPI_DOUBLE, U_all.data() + 1,
-    //                         MPI_DOUBLE, counts, displacements,
-    //                         N_rank_number);
-
-  } else {
-    parallel::Gather(N_rank_number, MPI_INT, N_curr_rank, MPI_INT);
-
-    parallel::GatherVarious(&U_new[1], MPI_DOUBLE, &U[1], MPI_DOUBLE,
-                            &N_curr_rank, &N_curr_rank, N_rank_number);
-    // parallel::GatherVarious(U_new.data() + 1, MPI_DOUBLE, U.data() + 1,
-    //                         MPI_DOUBLE, &N_curr_rank, &N_curr_rank,
-    //                         N_rank_number);
+    parallel::WriteDistributed(&U_new[write_beg], write_end - write_beg + 1);
   }
 
-  if (curr_rank == 0) VectorToFileWithPrecision(U_all);
-
   parallel::Finalize();
 
   return 0;
@@ -8,17 +8,18 @@
 
 
 int main() {
-  double pi = 0;
+  // точная сумма: результат не зависит от числа нитей (OMP_NUM_THREADS)
+  ReproducibleSum pi;
 
   int N = NumberFromFile("N.dat");
 
-#pragma omp parallel for shared(N) reduction(+ : pi)
+#pragma omp parallel for shared(N) reduction(reproducible_sum : pi)
   for (int i = 0; i < N; i++)
     pi += (SqrtFourMinusSqr(i * (2.0 / N)) +
            SqrtFourMinusSqr((2.0 / N) * (i + 1))) /
           2 * (2.0 / N);
 
-  std::cout << "Pi: " << pi << std::endl;
+  std::cout << "Pi: " << pi.Value() << std::endl;
 
   return 0;
 }
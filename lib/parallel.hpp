@@ -2,6 +2,21 @@
 
 #include <mpi.h>
 
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "reproducible.hpp"
 #include "utils.hpp"
 
 namespace parallel {
@@ -9,6 +24,28 @@ namespace parallel {
 /// @brief тег для сообщений MPI.
 #define PARALLEL_STANDARD_TAG 35817
 
+/// @brief тег для служебных сообщений MPI внутри обёрток.
+#define PARALLEL_SERVICE_TAG 35818
+
+/// @brief тег для коллективных операций на обменах точка-точка.
+#define PARALLEL_COLLECTIVE_TAG 35819
+
+/**
+ * @brief Максимальное количество элементов в одном вызове MPI. Более длинные
+ * векторы передаются частями (или через MPI-4 функции с суффиксом _c).
+ */
+#ifndef PARALLEL_MAX_COUNT
+#define PARALLEL_MAX_COUNT INT_MAX
+#endif
+
+/**
+ * @brief Размер части (байт), которыми блоки передаются по кольцу в
+ * RingAllOperation.
+ */
+#ifndef PARALLEL_RING_SEGMENT_BYTES
+#define PARALLEL_RING_SEGMENT_BYTES 65536
+#endif
+
 #define PARALLEL_NEED_PRINT true
 
 /**
@@ -128,6 +165,750 @@ inline void CurrRank(int &curr_rank, MPI_Comm comm = MPI_COMM_WORLD,
   if (need_print) std::cout << "SUCCESS" << std::endl;
 }
 
+/**
+ * @brief Признак того, что для типа T можно вывести тип данных MPI:
+ * арифметические типы и тривиально копируемые структуры.
+ * @details Собственные дескрипторы библиотеки, хранящие указатели
+ * (parallel::View, BufferPool::Block), исключены: их байты не имеют смысла
+ * на другом процессе.
+ * @tparam T: тип C++.
+ */
+template <typename T>
+struct is_mpi_type
+    : std::integral_constant<bool,
+                             std::is_arithmetic<T>::value ||
+                                 (std::is_class<T>::value &&
+                                  std::is_trivially_copyable<T>::value)> {};
+
+template <typename T>
+class View;
+
+template <typename T>
+struct is_mpi_type<View<T>> : std::false_type {};
+
+/**
+ * @brief Соответствие типа C++ типу данных MPI.
+ * @details Для арифметических типов возвращает встроенный тип MPI (см.
+ * специализации ниже). Для тривиально копируемых структур при первом вызове
+ * создаёт и регистрирует (MPI_Type_commit) непрерывный тип из sizeof(T)
+ * байт, который затем переиспользуется: такая структура передаётся одним
+ * сообщением, а не набором отдельных значений.
+ * @tparam T: тип C++.
+ */
+template <typename T>
+struct mpi_type {
+  static MPI_Datatype get() {
+    static_assert(is_mpi_type<T>::value,
+                  "parallel::mpi_type: T should be arithmetic or trivially "
+                  "copyable struct.");
+
+    static MPI_Datatype datatype = []() {
+      MPI_Datatype bytes_datatype;
+      parallel::CheckSuccess(MPI_Type_contiguous(static_cast<int>(sizeof(T)),
+                                                 MPI_BYTE, &bytes_datatype));
+      parallel::CheckSuccess(MPI_Type_commit(&bytes_datatype));
+
+      return bytes_datatype;
+    }();
+
+    return datatype;
+  }
+};
+
+/// @brief Специализация parallel::mpi_type для встроенного типа MPI.
+#define PARALLEL_MPI_TYPE(cpp_type, mpi_datatype)      \
+  template <>                                          \
+  struct mpi_type<cpp_type> {                          \
+    static MPI_Datatype get() { return mpi_datatype; } \
+  };
+
+PARALLEL_MPI_TYPE(bool, MPI_CXX_BOOL)
+PARALLEL_MPI_TYPE(char, MPI_CHAR)
+PARALLEL_MPI_TYPE(signed char, MPI_SIGNED_CHAR)
+PARALLEL_MPI_TYPE(unsigned char, MPI_UNSIGNED_CHAR)
+PARALLEL_MPI_TYPE(wchar_t, MPI_WCHAR)
+PARALLEL_MPI_TYPE(short, MPI_SHORT)
+PARALLEL_MPI_TYPE(unsigned short, MPI_UNSIGNED_SHORT)
+PARALLEL_MPI_TYPE(int, MPI_INT)
+PARALLEL_MPI_TYPE(unsigned int, MPI_UNSIGNED)
+PARALLEL_MPI_TYPE(long, MPI_LONG)
+PARALLEL_MPI_TYPE(unsigned long, MPI_UNSIGNED_LONG)
+PARALLEL_MPI_TYPE(long long, MPI_LONG_LONG)
+PARALLEL_MPI_TYPE(unsigned long long, MPI_UNSIGNED_LONG_LONG)
+PARALLEL_MPI_TYPE(float, MPI_FLOAT)
+PARALLEL_MPI_TYPE(double, MPI_DOUBLE)
+PARALLEL_MPI_TYPE(long double, MPI_LONG_DOUBLE)
+
+#undef PARALLEL_MPI_TYPE
+
+/**
+ * @brief Операция MPI, построенная из функтора C++ (MPI_Op_create).
+ * @details Функтор вызывается как functor(a, b) и возвращает результат
+ * операции над значениями a и b типа T, где a - значение процесса с меньшим
+ * рангом (для некоммутативных операций порядок важен). Операция
+ * регистрируется при первом вызове для пары (T, F) и флага коммутативности
+ * и затем переиспользуется, поэтому функтор не должен иметь состояния
+ * (лямбда-функция без захвата или пустая структура): иначе все вызовы
+ * выполняли бы операцию с состоянием первого.
+ * @tparam T: тип значений (арифметический или тривиально копируемая
+ * структура).
+ * @tparam F: тип функтора без состояния (в том числе лямбда-функции).
+ */
+template <typename T, typename F>
+struct user_op {
+  static MPI_Op get(const F &functor, bool is_commutative) {
+    static_assert(is_mpi_type<T>::value,
+                  "parallel::user_op: T should be arithmetic or trivially "
+                  "copyable struct.");
+    static_assert(std::is_empty<F>::value,
+                  "parallel::user_op: F should be stateless (lambda without "
+                  "captures or empty struct).");
+
+    static std::mutex op_mutex;
+    static MPI_Op ops[2] = {MPI_OP_NULL, MPI_OP_NULL};
+
+    std::lock_guard<std::mutex> lock(op_mutex);
+
+    if (Functor() == nullptr) Functor() = new F(functor);
+
+    MPI_Op &op = ops[is_commutative ? 1 : 0];
+
+    if (op == MPI_OP_NULL)
+      parallel::CheckSuccess(MPI_Op_create(&Apply, is_commutative, &op));
+
+    return op;
+  }
+
+ private:
+  static F *&Functor() {
+    static F *functor = nullptr;
+    return functor;
+  }
+
+  static void Apply(void *in, void *inout, int *len, MPI_Datatype *) {
+    const T *in_arr = static_cast<const T *>(in);
+    T *inout_arr = static_cast<T *>(inout);
+
+    const F &functor = *Functor();
+
+    for (int i = 0; i < *len; i++)
+      inout_arr[i] = functor(in_arr[i], inout_arr[i]);
+  }
+};
+
+/**
+ * @brief Регистрирует функтор C++ как операцию MPI, которую принимают
+ * Operation, AllOperation и другие обёртки над редукциями.
+ * @details Позволяет за одну редукцию свести составные значения (например,
+ * максимум невязки вместе с индексом и номером итерации). См.
+ * parallel::user_op.
+ * @tparam T: тип значений операции (указывается явно).
+ * @tparam F: тип функтора T(const T& a, const T& b) без состояния.
+ * @param functor: функтор операции.
+ * @param is_commutative: коммутативна ли операция. По умолчанию true.
+ * @return MPI_Op: зарегистрированная операция MPI.
+ */
+template <typename T, typename F>
+inline MPI_Op UserOperation(const F &functor, bool is_commutative = true) {
+  return user_op<T, F>::get(functor, is_commutative);
+}
+
+/**
+ * @brief Операция MPI точного слияния воспроизводимых сумм ReproducibleSum.
+ * @details Слияние выполняется в целых числах без округления, поэтому
+ * результат редукции не зависит от числа процессов и порядка их обхода.
+ * @return MPI_Op: зарегистрированная операция MPI.
+ */
+inline MPI_Op ReproducibleSumOperation() {
+  return UserOperation<ReproducibleSum>(
+      [](const ReproducibleSum &a, const ReproducibleSum &b) {
+        ReproducibleSum sum = a;
+        return sum += b;
+      });
+}
+
+/**
+ * @brief Возвращает зарегистрированный производный тип MPI для описания
+ * несплошной области, создавая его при первом запросе.
+ * @details Типы кэшируются по (тип элемента, форма области) и живут до
+ * завершения работы с MPI, поэтому повторные обмены одной и той же областью
+ * не создают типы заново.
+ * @param elem_datatype: тип данных элемента.
+ * @param shape: форма области: shape[0] = 0 для MPI_Type_vector (count,
+ * block_len, stride), shape[0] = 1 для MPI_Type_create_subarray (ndims,
+ * sizes, subsizes, starts).
+ * @return MPI_Datatype: производный тип данных.
+ */
+inline MPI_Datatype CachedDatatype(MPI_Datatype elem_datatype,
+                                   const std::vector<int> &shape) {
+  static std::map<std::pair<MPI_Datatype, std::vector<int>>, MPI_Datatype>
+      cache;
+  static std::mutex cache_mutex;
+
+  std::lock_guard<std::mutex> lock(cache_mutex);
+
+  std::pair<MPI_Datatype, std::vector<int>> key(elem_datatype, shape);
+
+  auto it = cache.find(key);
+  if (it != cache.end()) return it->second;
+
+  MPI_Datatype datatype;
+
+  if (shape[0] == 0)
+    parallel::CheckSuccess(MPI_Type_vector(shape[1], shape[2], shape[3],
+                                           elem_datatype, &datatype));
+  else {
+    int ndims = shape[1];
+
+    parallel::CheckSuccess(MPI_Type_create_subarray(
+        ndims, &shape[2], &shape[2 + ndims], &shape[2 + 2 * ndims],
+        MPI_ORDER_C, elem_datatype, &datatype));
+  }
+
+  parallel::CheckSuccess(MPI_Type_commit(&datatype));
+
+  cache[key] = datatype;
+
+  return datatype;
+}
+
+/**
+ * @brief Несплошная область памяти (столбец, грань сетки и т.п.), которую
+ * можно передавать по сети MPI без промежуточного копирования.
+ * @details Хранит адрес начала области и производный тип MPI, описывающий
+ * расположение элементов. Не владеет памятью. Создаётся функциями
+ * parallel::StridedView и parallel::SubarrayView.
+ * @tparam T: тип элементов (const T для областей, которые только
+ * отправляются).
+ */
+template <typename T>
+class View {
+ public:
+  View(T *data, MPI_Datatype datatype, int size)
+      : data_(data), datatype_(datatype), size_(size) {}
+
+  /// @return адрес, от которого отсчитывается область.
+  T *Data() const { return data_; }
+
+  /// @return производный тип MPI, описывающий область.
+  MPI_Datatype Datatype() const { return datatype_; }
+
+  /// @return количество элементов в области.
+  int Size() const { return size_; }
+
+ private:
+  T *data_;
+  MPI_Datatype datatype_;
+  int size_;
+};
+
+/**
+ * @brief Создаёт область из `count` блоков по `block_len` элементов, начала
+ * которых отстоят друг от друга на `stride` элементов (MPI_Type_vector).
+ * @details Например, столбец матрицы rows x cols в построчном хранении:
+ * StridedView(&matrix[col], rows, 1, cols).
+ * @tparam T: тип элементов.
+ * @param data: адрес первого элемента области.
+ * @param count: количество блоков.
+ * @param block_len: количество элементов в блоке.
+ * @param stride: расстояние между началами блоков (в элементах).
+ * @return parallel::View<T>: область.
+ */
+template <typename T>
+inline View<T> StridedView(T *data, int count, int block_len, int stride) {
+  if (count <= 0 || block_len <= 0)
+    parallel::Error(
+        "parallel::StridedView: count and block_len should be positive.");
+
+  std::vector<int> shape = {0, count, block_len, stride};
+
+  return View<T>(
+      data,
+      parallel::CachedDatatype(
+          mpi_type<typename std::remove_cv<T>::type>::get(), shape),
+      count * block_len);
+}
+
+/**
+ * @brief Создаёт область-подмассив многомерного массива в построчном (C)
+ * хранении (MPI_Type_create_subarray).
+ * @details Например, грань трёхмерной сетки nx x ny x nz с индексом k = 0:
+ * SubarrayView(grid.data(), {nx, ny, nz}, {nx, ny, 1}, {0, 0, 0}).
+ * @tparam T: тип элементов.
+ * @param data: адрес начала всего массива.
+ * @param sizes: размеры массива по каждому измерению.
+ * @param subsizes: размеры подмассива по каждому измерению.
+ * @param starts: начальные индексы подмассива по каждому измерению.
+ * @return parallel::View<T>: область.
+ */
+template <typename T>
+inline View<T> SubarrayView(T *data, const std::vector<int> &sizes,
+                            const std::vector<int> &subsizes,
+                            const std::vector<int> &starts) {
+  if (sizes.empty() || sizes.size() != subsizes.size() ||
+      sizes.size() != starts.size())
+    parallel::Error(
+        "parallel::SubarrayView: sizes, subsizes and starts should have the "
+        "same non-zero length.");
+
+  std::vector<int> shape = {1, static_cast<int>(sizes.size())};
+  shape.insert(shape.end(), sizes.begin(), sizes.end());
+  shape.insert(shape.end(), subsizes.begin(), subsizes.end());
+  shape.insert(shape.end(), starts.begin(), starts.end());
+
+  int size = 1;
+  for (std::size_t i = 0; i < subsizes.size(); i++) size *= subsizes[i];
+
+  return View<T>(
+      data,
+      parallel::CachedDatatype(
+          mpi_type<typename std::remove_cv<T>::type>::get(), shape),
+      size);
+}
+
+/**
+ * @brief Пул буферов для временных данных обёрток и коллективных операций.
+ * @details Буферы делятся на классы размеров (степени двойки, начиная с
+ * 64 байт) и после освобождения возвращаются в список свободных своего
+ * класса, поэтому в установившемся режиме итерационных схем куча не
+ * используется. Буферы до 4096 байт выровнены по кэш-линии (64 байта),
+ * большие - по странице (4096 байт). При включённом use_mpi_memory память
+ * выделяется через MPI_Alloc_mem (удобно для RDMA). Методы потокобезопасны.
+ */
+class BufferPool {
+ public:
+  /// @brief Выделенный из пула блок памяти.
+  struct Block {
+    void *raw = nullptr;
+    void *data = nullptr;
+    std::size_t size_class = 0;
+    bool is_mpi_memory = false;
+  };
+
+  /**
+   * @param use_mpi_memory: выделять ли память через MPI_Alloc_mem.
+   * По умолчанию false.
+   */
+  explicit BufferPool(bool use_mpi_memory = false)
+      : use_mpi_memory_(use_mpi_memory) {}
+
+  BufferPool(const BufferPool &) = delete;
+  BufferPool &operator=(const BufferPool &) = delete;
+
+  ~BufferPool() { Clear(); }
+
+  /// @return BufferPool&: общий пул, используемый обёртками.
+  static BufferPool &Global() {
+    static BufferPool pool;
+    return pool;
+  }
+
+  /**
+   * @brief Выдаёт блок размером не меньше bytes байт.
+   * @param bytes: необходимый размер (в байтах).
+   * @return Block: выделенный блок (пустой при bytes == 0).
+   */
+  Block Acquire(std::size_t bytes) {
+    Block block;
+    if (bytes == 0) return block;
+
+    block.size_class = SizeClass(bytes);
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+
+      if (block.size_class < free_lists_.size() &&
+          !free_lists_[block.size_class].empty()) {
+        block = free_lists_[block.size_class].back();
+        free_lists_[block.size_class].pop_back();
+        return block;
+      }
+    }
+
+    std::size_t class_bytes = ClassBytes(block.size_class);
+    std::size_t alignment = Alignment(block.size_class);
+
+    int is_initialized = 0;
+    int is_finalized = 0;
+    MPI_Initialized(&is_initialized);
+    MPI_Finalized(&is_finalized);
+
+    block.is_mpi_memory = use_mpi_memory_ && is_initialized && !is_finalized;
+
+    if (block.is_mpi_memory)
+      parallel::CheckSuccess(
+          MPI_Alloc_mem(static_cast<MPI_Aint>(class_bytes + alignment),
+                        MPI_INFO_NULL, &block.raw));
+    else
+      block.raw = std::malloc(class_bytes + alignment);
+
+    if (block.raw == nullptr)
+      parallel::Error("parallel::BufferPool::Acquire: out of memory.");
+
+    std::uintptr_t address = reinterpret_cast<std::uintptr_t>(block.raw);
+    address = (address + alignment - 1) / alignment * alignment;
+    block.data = reinterpret_cast<void *>(address);
+
+    return block;
+  }
+
+  /**
+   * @brief Возвращает блок в пул.
+   * @param block: блок, ранее выданный методом Acquire этого пула.
+   */
+  void Release(const Block &block) {
+    if (block.raw == nullptr) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (block.size_class >= free_lists_.size())
+      free_lists_.resize(block.size_class + 1);
+
+    free_lists_[block.size_class].push_back(block);
+  }
+
+  /// @brief Освобождает все свободные блоки пула.
+  void Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    int is_finalized = 0;
+    MPI_Finalized(&is_finalized);
+
+    for (std::size_t i = 0; i < free_lists_.size(); i++)
+      for (std::size_t j = 0; j < free_lists_[i].size(); j++) {
+        Block &block = free_lists_[i][j];
+
+        // после MPI_Finalize память MPI освободится вместе с процессом
+        if (!block.is_mpi_memory)
+          std::free(block.raw);
+        else if (!is_finalized)
+          MPI_Free_mem(block.raw);
+      }
+
+    free_lists_.clear();
+  }
+
+  /**
+   * @brief Включает или выключает выделение новых блоков через MPI_Alloc_mem.
+   * @param use_mpi_memory: выделять ли память через MPI_Alloc_mem.
+   */
+  void SetUseMpiMemory(bool use_mpi_memory) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    use_mpi_memory_ = use_mpi_memory;
+  }
+
+ private:
+  static std::size_t ClassBytes(std::size_t size_class) {
+    return std::size_t(64) << size_class;
+  }
+
+  static std::size_t Alignment(std::size_t size_class) {
+    return ClassBytes(size_class) >= 4096 ? 4096 : 64;
+  }
+
+  static std::size_t SizeClass(std::size_t bytes) {
+    std::size_t size_class = 0;
+    while (ClassBytes(size_class) < bytes) size_class++;
+
+    return size_class;
+  }
+
+  std::mutex mutex_;
+  std::vector<std::vector<Block>> free_lists_;
+  bool use_mpi_memory_;
+};
+
+template <>
+struct is_mpi_type<BufferPool::Block> : std::false_type {};
+
+/**
+ * @brief Временный массив, память которого берётся из BufferPool и
+ * возвращается туда при уничтожении.
+ * @details Объект можно только перемещать, но не копировать. Элементы не
+ * инициализируются.
+ * @tparam T: тип элементов (тривиальный).
+ */
+template <typename T>
+class PooledBuffer {
+  static_assert(std::is_trivial<T>::value,
+                "parallel::PooledBuffer: T should be trivial.");
+
+ public:
+  /**
+   * @param size: количество элементов.
+   * @param pool: пул, из которого берётся память. По умолчанию общий.
+   */
+  explicit PooledBuffer(std::size_t size,
+                        BufferPool &pool = BufferPool::Global())
+      : pool_(&pool), block_(pool.Acquire(size * sizeof(T))), size_(size) {}
+
+  PooledBuffer(const PooledBuffer &) = delete;
+  PooledBuffer &operator=(const PooledBuffer &) = delete;
+
+  PooledBuffer(PooledBuffer &&other)
+      : pool_(other.pool_), block_(other.block_), size_(other.size_) {
+    other.block_ = BufferPool::Block();
+    other.size_ = 0;
+  }
+
+  PooledBuffer &operator=(PooledBuffer &&other) {
+    if (this != &other) {
+      pool_->Release(block_);
+
+      pool_ = other.pool_;
+      block_ = other.block_;
+      size_ = other.size_;
+
+      other.block_ = BufferPool::Block();
+      other.size_ = 0;
+    }
+
+    return *this;
+  }
+
+  ~PooledBuffer() { pool_->Release(block_); }
+
+  T *Data() { return static_cast<T *>(block_.data); }
+  const T *Data() const { return static_cast<const T *>(block_.data); }
+
+  std::size_t Size() const { return size_; }
+
+  T &operator[](std::size_t index) { return Data()[index]; }
+  const T &operator[](std::size_t index) const { return Data()[index]; }
+
+ private:
+  BufferPool *pool_;
+  BufferPool::Block block_;
+  std::size_t size_;
+};
+
+/**
+ * @brief Отправляет массив произвольной (64-битной) длины по сети MPI.
+ * @details При MPI >= 4 используется MPI_Send_c, иначе массив отправляется
+ * последовательными частями не длиннее PARALLEL_MAX_COUNT элементов
+ * (порядок сообщений между парой процессов сохраняется стандартом MPI).
+ * Последняя часть всегда короче PARALLEL_MAX_COUNT (при необходимости
+ * пустая): по ней parallel::ReceiveLarge узнаёт конец сообщения.
+ * @tparam T: тип элементов массива.
+ * @param arr: массив, который нужно отправить.
+ * @param arr_len: количество элементов в массиве.
+ * @param datatype: тип данных элементов массива.
+ * @param to_rank: ранг получателя.
+ * @param tag: тег сообщения.
+ * @param comm: коммуникатор MPI.
+ */
+template <typename T>
+inline void SendLarge(const T *arr, std::size_t arr_len, MPI_Datatype datatype,
+                      int to_rank, int tag, MPI_Comm comm) {
+#if MPI_VERSION >= 4
+  parallel::CheckSuccess(MPI_Send_c(arr, static_cast<MPI_Count>(arr_len),
+                                    datatype, to_rank, tag, comm));
+#else
+  for (std::size_t offset = 0;; offset += PARALLEL_MAX_COUNT) {
+    int chunk_len = static_cast<int>(
+        Min(arr_len - offset, static_cast<std::size_t>(PARALLEL_MAX_COUNT)));
+
+    parallel::CheckSuccess(
+        MPI_Send(arr + offset, chunk_len, datatype, to_rank, tag, comm));
+
+    if (chunk_len < PARALLEL_MAX_COUNT) break;
+  }
+#endif
+}
+
+/**
+ * @brief Получает массив произвольной (64-битной) длины по сети MPI.
+ * @details Парная функция к parallel::SendLarge. После получения первой
+ * части отправитель и тег фиксируются, поэтому части сообщений от разных
+ * процессов (при MPI_ANY_SOURCE) не перемешиваются. Части принимаются до
+ * первой неполной, поэтому массив может быть длиннее сообщения (как и в
+ * MPI_Recv), а сообщение из одной неполной части (обычный parallel::Send)
+ * тоже принимается.
+ * @tparam T: тип элементов массива.
+ * @param arr: массив, в который нужно получить данные.
+ * @param arr_len: количество элементов в массиве (не меньше длины
+ * сообщения).
+ * @param datatype: тип данных элементов массива.
+ * @param from_rank: ранг отправителя.
+ * @param tag: тег сообщения.
+ * @param comm: коммуникатор MPI.
+ * @param status: статус первой части сообщения (или MPI_STATUS_IGNORE).
+ */
+template <typename T>
+inline void ReceiveLarge(T *arr, std::size_t arr_len, MPI_Datatype datatype,
+                         int from_rank, int tag, MPI_Comm comm,
+                         MPI_Status *status) {
+#if MPI_VERSION >= 4
+  parallel::CheckSuccess(MPI_Recv_c(arr, static_cast<MPI_Count>(arr_len),
+                                    datatype, from_rank, tag, comm, status));
+#else
+  for (std::size_t offset = 0;; offset += PARALLEL_MAX_COUNT) {
+    int chunk_len = static_cast<int>(
+        Min(arr_len - offset, static_cast<std::size_t>(PARALLEL_MAX_COUNT)));
+
+    MPI_Status chunk_status;
+    parallel::CheckSuccess(MPI_Recv(arr + offset, chunk_len, datatype,
+                                    from_rank, tag, comm, &chunk_status));
+
+    from_rank = chunk_status.MPI_SOURCE;
+    tag = chunk_status.MPI_TAG;
+
+    if (offset == 0 && status != MPI_STATUS_IGNORE) *status = chunk_status;
+
+    int received_len = 0;
+    parallel::CheckSuccess(
+        MPI_Get_count(&chunk_status, datatype, &received_len));
+
+    if (received_len < PARALLEL_MAX_COUNT) break;
+  }
+#endif
+}
+
+/**
+ * @brief Рассылает массив произвольной (64-битной) длины по сети MPI.
+ * @details При MPI >= 4 используется MPI_Bcast_c, иначе массив рассылается
+ * частями не длиннее PARALLEL_MAX_COUNT элементов.
+ * @tparam T: тип элементов массива.
+ * @param arr: рассылаемый массив.
+ * @param arr_len: количество элементов в массиве.
+ * @param datatype: тип данных элементов массива.
+ * @param from_rank: ранг процесса рассылки.
+ * @param comm: коммуникатор MPI.
+ */
+template <typename T>
+inline void BroadcastLarge(T *arr, std::size_t arr_len, MPI_Datatype datatype,
+                           int from_rank, MPI_Comm comm) {
+#if MPI_VERSION >= 4
+  parallel::CheckSuccess(MPI_Bcast_c(arr, static_cast<MPI_Count>(arr_len),
+                                     datatype, from_rank, comm));
+#else
+  for (std::size_t offset = 0; offset < arr_len;
+       offset += PARALLEL_MAX_COUNT) {
+    int chunk_len = static_cast<int>(
+        Min(arr_len - offset, static_cast<std::size_t>(PARALLEL_MAX_COUNT)));
+
+    parallel::CheckSuccess(
+        MPI_Bcast(arr + offset, chunk_len, datatype, from_rank, comm));
+  }
+#endif
+}
+
+/**
+ * @brief Выполняет операцию над массивом произвольной (64-битной) длины и
+ * отправляет результат на указанный процесс в сети MPI.
+ * @details При MPI >= 4 используется MPI_Reduce_c, иначе операция
+ * выполняется поэлементно по частям не длиннее PARALLEL_MAX_COUNT элементов.
+ * @tparam T: тип значения в массиве.
+ * @param from_arr: исходный массив значений.
+ * @param to_arr: массив, куда будет записан результат операции.
+ * @param arr_len: количество элементов в массиве.
+ * @param datatype: тип данных элементов массива.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param to_rank: ранг процесса результата.
+ * @param comm: коммуникатор MPI.
+ */
+template <typename T>
+inline void OperationLarge(const T *from_arr, T *to_arr, std::size_t arr_len,
+                           MPI_Datatype datatype, MPI_Op op, int to_rank,
+                           MPI_Comm comm) {
+#if MPI_VERSION >= 4
+  parallel::CheckSuccess(MPI_Reduce_c(from_arr, to_arr,
+                                      static_cast<MPI_Count>(arr_len),
+                                      datatype, op, to_rank, comm));
+#else
+  bool is_root = parallel::CurrRank(comm) == to_rank;
+
+  for (std::size_t offset = 0; offset < arr_len;
+       offset += PARALLEL_MAX_COUNT) {
+    int chunk_len = static_cast<int>(
+        Min(arr_len - offset, static_cast<std::size_t>(PARALLEL_MAX_COUNT)));
+
+    parallel::CheckSuccess(MPI_Reduce(from_arr + offset,
+                                      is_root ? to_arr + offset : to_arr,
+                                      chunk_len, datatype, op, to_rank, comm));
+  }
+#endif
+}
+
+/**
+ * @brief Выполняет операцию над массивом произвольной (64-битной) длины и
+ * рассылает результат всем процессам в сети MPI.
+ * @details При MPI >= 4 используется MPI_Allreduce_c, иначе операция
+ * выполняется поэлементно по частям не длиннее PARALLEL_MAX_COUNT элементов.
+ * Если from_arr совпадает с to_arr, используется MPI_IN_PLACE.
+ * @tparam T: тип значения в массиве.
+ * @param from_arr: исходный массив значений.
+ * @param to_arr: массив, куда будет записан результат операции.
+ * @param arr_len: количество элементов в массиве.
+ * @param datatype: тип данных элементов массива.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI.
+ */
+template <typename T>
+inline void AllOperationLarge(const T *from_arr, T *to_arr,
+                              std::size_t arr_len, MPI_Datatype datatype,
+                              MPI_Op op, MPI_Comm comm) {
+  bool is_in_place = from_arr == to_arr;
+
+#if MPI_VERSION >= 4
+  parallel::CheckSuccess(MPI_Allreduce_c(
+      is_in_place ? MPI_IN_PLACE : from_arr, to_arr,
+      static_cast<MPI_Count>(arr_len), datatype, op, comm));
+#else
+  for (std::size_t offset = 0; offset < arr_len;
+       offset += PARALLEL_MAX_COUNT) {
+    int chunk_len = static_cast<int>(
+        Min(arr_len - offset, static_cast<std::size_t>(PARALLEL_MAX_COUNT)));
+
+    parallel::CheckSuccess(MPI_Allreduce(
+        is_in_place ? MPI_IN_PLACE : from_arr + offset, to_arr + offset,
+        chunk_len, datatype, op, comm));
+  }
+#endif
+}
+
+/**
+ * @brief Собирает массивы одинаковой произвольной (64-битной) длины от всех
+ * процессов в сети MPI в одном процессе.
+ * @details При MPI >= 4 используется MPI_Gather_c, иначе каждый процесс
+ * отправляет свой массив процессу `to_rank` через parallel::SendLarge.
+ * @tparam T: тип значения в массиве.
+ * @param from_arr: массив, который будет отправлен от текущего процесса.
+ * @param arr_len: количество элементов в массиве `from_arr`.
+ * @param from_datatype: тип данных элементов массива `from_arr`.
+ * @param to_arr: массив, куда будет записан результат сбора на процессе
+ * `to_rank` (arr_len элементов от каждого процесса).
+ * @param to_datatype: тип данных элементов массива `to_arr`.
+ * @param to_rank: ранг процесса результата.
+ * @param comm: коммуникатор MPI.
+ */
+template <typename T>
+inline void GatherLarge(const T *from_arr, std::size_t arr_len,
+                        MPI_Datatype from_datatype, T *to_arr,
+                        MPI_Datatype to_datatype, int to_rank, MPI_Comm comm) {
+#if MPI_VERSION >= 4
+  parallel::CheckSuccess(MPI_Gather_c(
+      from_arr, static_cast<MPI_Count>(arr_len), from_datatype, to_arr,
+      static_cast<MPI_Count>(arr_len), to_datatype, to_rank, comm));
+#else
+  int ranks_amount = parallel::RanksAmount(comm);
+  int curr_rank = parallel::CurrRank(comm);
+
+  if (curr_rank != to_rank) {
+    parallel::SendLarge(from_arr, arr_len, from_datatype, to_rank,
+                        PARALLEL_SERVICE_TAG, comm);
+    return;
+  }
+
+  std::copy(from_arr, from_arr + arr_len, to_arr + curr_rank * arr_len);
+
+  for (int i = 0; i < ranks_amount; i++)
+    if (i != curr_rank)
+      parallel::ReceiveLarge(to_arr + i * arr_len, arr_len, to_datatype, i,
+                             PARALLEL_SERVICE_TAG, comm, MPI_STATUS_IGNORE);
+#endif
+}
+
 /**
  * @brief Отправляет значение по сети MPI.
  * @tparam T: тип отправляемого значения.
@@ -138,7 +919,7 @@ inline void CurrRank(int &curr_rank, MPI_Comm comm = MPI_COMM_WORLD,
  * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
  */
 template <typename T>
-inline void Send(T &value, MPI_Datatype datatype, unsigned int to_rank,
+inline void Send(const T &value, MPI_Datatype datatype, unsigned int to_rank,
                  int tag = PARALLEL_STANDARD_TAG,
                  MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
   if (need_print)
@@ -197,15 +978,61 @@ inline void Send(const std::vector<T> &vec, MPI_Datatype datatype,
               << "; datatype: " << datatype << "; to_rank: " << to_rank
               << "; tag: " << tag << "; comm: " << comm;
 
-  if (vec.size() > INT_MAX)
-    parallel::Error("parallel::Send: vector is too big (size > INT_MAX).");
-
-  parallel::Send(vec.data(), static_cast<int>(vec.size()), datatype, to_rank,
-                 tag, comm);
+  // вектор любого размера идёт через SendLarge, чтобы получатель с вектором
+  // другого размера разбирал сообщение по тем же правилам
+  parallel::SendLarge(vec.data(), vec.size(), datatype, to_rank, tag, comm);
 
   if (need_print) std::cout << "SUCCESS" << std::endl;
 }
 
+/**
+ * @brief Отправляет значение по сети MPI (тип данных выводится из T).
+ * @tparam T: тип отправляемого значения.
+ * @param value: отправляемое значение.
+ * @param to_rank: ранг получателя.
+ * @param tag: тег сообщения. По умолчанию PARALLEL_STANDARD_TAG.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T,
+          typename = typename std::enable_if<is_mpi_type<T>::value>::type>
+inline void Send(const T &value, unsigned int to_rank,
+                 int tag = PARALLEL_STANDARD_TAG,
+                 MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
+  parallel::Send(&value, 1, mpi_type<T>::get(), to_rank, tag, comm, need_print);
+}
+
+/**
+ * @brief Отправляет массив по сети MPI (тип данных выводится из T).
+ * @tparam T: тип элементов массива.
+ * @param arr: массив, который нужно отправить.
+ * @param arr_len: количество элементов в массиве.
+ * @param to_rank: ранг получателя.
+ * @param tag: тег сообщения. По умолчанию PARALLEL_STANDARD_TAG.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void Send(const T *arr, int arr_len, unsigned int to_rank,
+                 int tag = PARALLEL_STANDARD_TAG,
+                 MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
+  parallel::Send(arr, arr_len, mpi_type<T>::get(), to_rank, tag, comm,
+                 need_print);
+}
+
+/**
+ * @brief Отправляет вектор по сети MPI (тип данных выводится из T).
+ * @tparam T: тип элементов вектора.
+ * @param vec: вектор, который нужно отправить.
+ * @param to_rank: ранг получателя.
+ * @param tag: тег сообщения. По умолчанию PARALLEL_STANDARD_TAG.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void Send(const std::vector<T> &vec, unsigned int to_rank,
+                 int tag = PARALLEL_STANDARD_TAG,
+                 MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
+  parallel::Send(vec, mpi_type<T>::get(), to_rank, tag, comm, need_print);
+}
+
 /**
  * @brief Получает значение по сети MPI.
  * @tparam T: тип получаемого значения.
@@ -283,31 +1110,84 @@ inline void Receive(std::vector<T> &vec, MPI_Datatype datatype,
               << "; datatype: " << datatype << "; from_rank: " << from_rank
               << "; tag: " << tag << "; comm: " << comm;
 
-  if (vec.size() > INT_MAX)
-    parallel::Error("parallel::Receive: vector is too big (size > INT_MAX).");
-
-  parallel::Receive(vec.data(), static_cast<int>(vec.size()), datatype, &status,
-                    from_rank, tag, comm);
+  parallel::ReceiveLarge(vec.data(), vec.size(), datatype, from_rank, tag,
+                         comm, &status);
 
   if (need_print) std::cout << "SUCCESS" << std::endl;
 }
 
 /**
- * @brief Получает значение по сети MPI.
+ * @brief Получает значение по сети MPI (тип данных выводится из T).
  * @tparam T: тип получаемого значения.
  * @param value: получаемое значение.
- * @param datatype: тип данных значения.
+ * @param status: статус сообщения.
  * @param from_rank: ранг отправителя. По умолчанию MPI_ANY_SOURCE.
  * @param tag: тег сообщения. По умолчанию PARALLEL_STANDARD_TAG.
  * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
  */
-template <typename T>
-inline void ReceiveIgnoreStatus(T &value, MPI_Datatype datatype,
-                                int from_rank = MPI_ANY_SOURCE,
-                                int tag = PARALLEL_STANDARD_TAG,
-                                MPI_Comm comm = MPI_COMM_WORLD,
-                                bool need_print = false) {
-  if (need_print)
+template <typename T,
+          typename = typename std::enable_if<is_mpi_type<T>::value>::type>
+inline void Receive(T &value, MPI_Status &status,
+                    int from_rank = MPI_ANY_SOURCE,
+                    int tag = PARALLEL_STANDARD_TAG,
+                    MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
+  parallel::Receive(&value, 1, mpi_type<T>::get(), status, from_rank, tag, comm,
+                    need_print);
+}
+
+/**
+ * @brief Получает массив по сети MPI (тип данных выводится из T).
+ * @tparam T: тип элементов массива.
+ * @param arr: массив, в который нужно получить данные.
+ * @param arr_len: количество элементов в массиве.
+ * @param status: статус сообщения.
+ * @param from_rank: ранг отправителя. По умолчанию MPI_ANY_SOURCE.
+ * @param tag: тег сообщения. По умолчанию PARALLEL_STANDARD_TAG.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void Receive(T *arr, int arr_len, MPI_Status &status,
+                    int from_rank = MPI_ANY_SOURCE,
+                    int tag = PARALLEL_STANDARD_TAG,
+                    MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
+  parallel::Receive(arr, arr_len, mpi_type<T>::get(), status, from_rank, tag,
+                    comm, need_print);
+}
+
+/**
+ * @brief Получает вектор по сети MPI (тип данных выводится из T).
+ * @tparam T: тип элементов вектора.
+ * @param vec: вектор, в который нужно получить данные.
+ * @param status: статус сообщения.
+ * @param from_rank: ранг отправителя. По умолчанию MPI_ANY_SOURCE.
+ * @param tag: тег сообщения. По умолчанию PARALLEL_STANDARD_TAG.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void Receive(std::vector<T> &vec, MPI_Status &status,
+                    int from_rank = MPI_ANY_SOURCE,
+                    int tag = PARALLEL_STANDARD_TAG,
+                    MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
+  parallel::Receive(vec, mpi_type<T>::get(), status, from_rank, tag, comm,
+                    need_print);
+}
+
+/**
+ * @brief Получает значение по сети MPI.
+ * @tparam T: тип получаемого значения.
+ * @param value: получаемое значение.
+ * @param datatype: тип данных значения.
+ * @param from_rank: ранг отправителя. По умолчанию MPI_ANY_SOURCE.
+ * @param tag: тег сообщения. По умолчанию PARALLEL_STANDARD_TAG.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void ReceiveIgnoreStatus(T &value, MPI_Datatype datatype,
+                                int from_rank = MPI_ANY_SOURCE,
+                                int tag = PARALLEL_STANDARD_TAG,
+                                MPI_Comm comm = MPI_COMM_WORLD,
+                                bool need_print = false) {
+  if (need_print)
     std::cout << "parallel::ReceiveIgnoreStatus with args: value: " << value
               << "; datatype: " << datatype << "; from_rank: " << from_rank
               << "; tag: " << tag << "; comm: " << comm;
@@ -369,373 +1249,6782 @@ inline void ReceiveIgnoreStatus(std::vector<T> &vec, MPI_Datatype datatype,
               << "; datatype: " << datatype << "; from_rank: " << from_rank
               << "; tag: " << tag << "; comm: " << comm;
 
-  if (vec.size() > INT_MAX)
-    parallel::Error("parallel::Receive: vector is too big (size > INT_MAX).");
-
-  parallel::ReceiveIgnoreStatus(vec.data(), static_cast<int>(vec.size()),
-                                datatype, from_rank, tag, comm);
+  parallel::ReceiveLarge(vec.data(), vec.size(), datatype, from_rank, tag,
+                         comm, MPI_STATUS_IGNORE);
 
   if (need_print) std::cout << "SUCCESS" << std::endl;
 }
 
 /**
- * @brief Рассылает значение от процесса с указанным рангом по сети MPI.
- * @tparam T: тип рассылаемого значения.
- * @param value: рассылаемое значение.
- * @param datatype: тип данных значения.
- * @param from_rank: ранг процесса рассылки. По умолчанию 0.
+ * @brief Получает значение по сети MPI (тип данных выводится из T).
+ * @tparam T: тип получаемого значения.
+ * @param value: получаемое значение.
+ * @param from_rank: ранг отправителя. По умолчанию MPI_ANY_SOURCE.
+ * @param tag: тег сообщения. По умолчанию PARALLEL_STANDARD_TAG.
  * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
  */
-template <typename T>
-inline void Broadcast(T &value, MPI_Datatype datatype, int from_rank = 0,
-                      MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
-  if (need_print)
-    std::cout << "parallel::Broadcast with args: value: " << value
-              << "; datatype: " << datatype << "; from_rank: " << from_rank
-              << "; comm: " << comm;
+template <typename T,
+          typename = typename std::enable_if<is_mpi_type<T>::value>::type>
+inline void ReceiveIgnoreStatus(T &value, int from_rank = MPI_ANY_SOURCE,
+                                int tag = PARALLEL_STANDARD_TAG,
+                                MPI_Comm comm = MPI_COMM_WORLD,
+                                bool need_print = false) {
+  parallel::ReceiveIgnoreStatus(&value, 1, mpi_type<T>::get(), from_rank, tag,
+                                comm, need_print);
+}
 
-  parallel::CheckSuccess(MPI_Bcast(&value, 1, datatype, from_rank, comm));
+/**
+ * @brief Получает массив по сети MPI (тип данных выводится из T).
+ * @tparam T: тип элементов массива.
+ * @param arr: массив, в который нужно получить данные.
+ * @param arr_len: количество элементов в массиве.
+ * @param from_rank: ранг отправителя. По умолчанию MPI_ANY_SOURCE.
+ * @param tag: тег сообщения. По умолчанию PARALLEL_STANDARD_TAG.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void ReceiveIgnoreStatus(T *arr, int arr_len,
+                                int from_rank = MPI_ANY_SOURCE,
+                                int tag = PARALLEL_STANDARD_TAG,
+                                MPI_Comm comm = MPI_COMM_WORLD,
+                                bool need_print = false) {
+  parallel::ReceiveIgnoreStatus(arr, arr_len, mpi_type<T>::get(), from_rank,
+                                tag, comm, need_print);
+}
 
-  if (need_print) std::cout << "SUCCESS" << std::endl;
+/**
+ * @brief Получает вектор по сети MPI (тип данных выводится из T).
+ * @tparam T: тип элементов вектора.
+ * @param vec: вектор, в который нужно получить данные.
+ * @param from_rank: ранг отправителя. По умолчанию MPI_ANY_SOURCE.
+ * @param tag: тег сообщения. По умолчанию PARALLEL_STANDARD_TAG.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void ReceiveIgnoreStatus(std::vector<T> &vec,
+                                int from_rank = MPI_ANY_SOURCE,
+                                int tag = PARALLEL_STANDARD_TAG,
+                                MPI_Comm comm = MPI_COMM_WORLD,
+                                bool need_print = false) {
+  parallel::ReceiveIgnoreStatus(vec, mpi_type<T>::get(), from_rank, tag, comm,
+                                need_print);
 }
 
 /**
- * @brief Рассылает массив от процесса с указанным рангом по сети MPI.
- * @tparam T: тип элементов рассылаемого массива.
- * @param arr: рассылаемый массив.
- * @param arr_len: количество элементов в массиве.
- * @param datatype: тип данных элементов массива.
- * @param from_rank: ранг процесса рассылки. По умолчанию 0.
+ * @brief Получает вектор заранее неизвестного размера по сети MPI.
+ * @details Размер сообщения определяется через MPI_Mprobe и MPI_Get_count,
+ * после чего вектор приводится к нужному размеру (уже выделенная память
+ * переиспользуется, если её хватает) и именно это сообщение принимается
+ * через MPI_Mrecv, поэтому между пробой и получением его не может
+ * перехватить другой поток или вызов. При MPI < 4 векторы не короче
+ * PARALLEL_MAX_COUNT элементов parallel::SendLarge отправляет частями без
+ * заголовка, и их полный размер по первой части не определить: такие
+ * сообщения завершаются ошибкой (их следует получать через Receive в
+ * вектор известного размера).
+ * @tparam T: тип элементов вектора.
+ * @param vec: вектор, в который нужно получить данные.
+ * @param datatype: тип данных элементов вектора.
+ * @param status: статус сообщения.
+ * @param from_rank: ранг отправителя. По умолчанию MPI_ANY_SOURCE.
+ * @param tag: тег сообщения. По умолчанию PARALLEL_STANDARD_TAG.
  * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
  */
 template <typename T>
-inline void Broadcast(T *arr, int arr_len, MPI_Datatype datatype,
-                      int from_rank = 0, MPI_Comm comm = MPI_COMM_WORLD,
-                      bool need_print = false) {
+inline void ReceiveResize(std::vector<T> &vec, MPI_Datatype datatype,
+                          MPI_Status &status, int from_rank = MPI_ANY_SOURCE,
+                          int tag = PARALLEL_STANDARD_TAG,
+                          MPI_Comm comm = MPI_COMM_WORLD,
+                          bool need_print = false) {
   if (need_print)
-    std::cout << "parallel::Broadcast with args: arr: " << arr
-              << "; arr_len: " << arr_len << "; datatype: " << datatype
-              << "; from_rank: " << from_rank << "; comm: " << comm;
+    std::cout << "parallel::ReceiveResize with args: vec_capacity: "
+              << vec.capacity() << "; datatype: " << datatype
+              << "; from_rank: " << from_rank << "; tag: " << tag
+              << "; comm: " << comm;
 
-  if (arr_len <= 0)
-    parallel::Error("parallel::Broadcast: arr_len should be non-negative.");
+  MPI_Message message;
+  parallel::CheckSuccess(MPI_Mprobe(from_rank, tag, comm, &message, &status));
 
-  parallel::CheckSuccess(MPI_Bcast(arr, arr_len, datatype, from_rank, comm));
+#if MPI_VERSION >= 4
+  MPI_Count count = 0;
+  parallel::CheckSuccess(MPI_Get_count_c(&status, datatype, &count));
+
+  if (count == MPI_UNDEFINED)
+    parallel::Error(
+        "parallel::ReceiveResize: message size is not a multiple of "
+        "datatype.");
+
+  vec.resize(count);
+
+  parallel::CheckSuccess(
+      MPI_Mrecv_c(vec.data(), count, datatype, &message, &status));
+#else
+  int count = 0;
+  parallel::CheckSuccess(MPI_Get_count(&status, datatype, &count));
+
+  if (count == MPI_UNDEFINED)
+    parallel::Error(
+        "parallel::ReceiveResize: message size is not a multiple of datatype "
+        "or is too big (size > INT_MAX).");
+
+  // полная часть может быть лишь началом вектора, посланного SendLarge
+  if (count >= PARALLEL_MAX_COUNT)
+    parallel::Error(
+        "parallel::ReceiveResize: vector of PARALLEL_MAX_COUNT or more "
+        "elements is sent in parts; receive it into a vector of known "
+        "size.");
+
+  vec.resize(count);
+
+  parallel::CheckSuccess(
+      MPI_Mrecv(vec.data(), count, datatype, &message, &status));
+#endif
 
   if (need_print) std::cout << "SUCCESS" << std::endl;
 }
 
 /**
- * @brief Рассылает вектор от процесса с указанным рангом по сети MPI.
- * @tparam T: тип элементов рассылаемого вектора.
- * @param vec: рассылаемый вектор.
+ * @brief Получает вектор заранее неизвестного размера по сети MPI (тип
+ * данных выводится из T).
+ * @tparam T: тип элементов вектора.
+ * @param vec: вектор, в который нужно получить данные.
+ * @param status: статус сообщения.
+ * @param from_rank: ранг отправителя. По умолчанию MPI_ANY_SOURCE.
+ * @param tag: тег сообщения. По умолчанию PARALLEL_STANDARD_TAG.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void ReceiveResize(std::vector<T> &vec, MPI_Status &status,
+                          int from_rank = MPI_ANY_SOURCE,
+                          int tag = PARALLEL_STANDARD_TAG,
+                          MPI_Comm comm = MPI_COMM_WORLD,
+                          bool need_print = false) {
+  parallel::ReceiveResize(vec, mpi_type<T>::get(), status, from_rank, tag,
+                          comm, need_print);
+}
+
+/**
+ * @brief Получает вектор заранее неизвестного размера по сети MPI.
+ * @tparam T: тип элементов вектора.
+ * @param vec: вектор, в который нужно получить данные.
  * @param datatype: тип данных элементов вектора.
- * @param from_rank: ранг процесса рассылки. По умолчанию 0.
+ * @param from_rank: ранг отправителя. По умолчанию MPI_ANY_SOURCE.
+ * @param tag: тег сообщения. По умолчанию PARALLEL_STANDARD_TAG.
  * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
  */
 template <typename T>
-inline void Broadcast(std::vector<T> vec, MPI_Datatype datatype,
-                      int from_rank = 0, MPI_Comm comm = MPI_COMM_WORLD,
-                      bool need_print = false) {
-  if (need_print)
-    std::cout << "parallel::Broadcast with args: vec: " << vec
-              << "; datatype: " << datatype << "; from_rank: " << from_rank
-              << "; comm: " << comm;
+inline void ReceiveResizeIgnoreStatus(std::vector<T> &vec,
+                                      MPI_Datatype datatype,
+                                      int from_rank = MPI_ANY_SOURCE,
+                                      int tag = PARALLEL_STANDARD_TAG,
+                                      MPI_Comm comm = MPI_COMM_WORLD,
+                                      bool need_print = false) {
+  MPI_Status status;
+  parallel::ReceiveResize(vec, datatype, status, from_rank, tag, comm,
+                          need_print);
+}
 
-  if (vec.size() > INT_MAX)
-    parallel::Error("parallel::Broadcast: vector is too big (size > INT_MAX).");
+/**
+ * @brief Получает вектор заранее неизвестного размера по сети MPI (тип
+ * данных выводится из T).
+ * @tparam T: тип элементов вектора.
+ * @param vec: вектор, в который нужно получить данные.
+ * @param from_rank: ранг отправителя. По умолчанию MPI_ANY_SOURCE.
+ * @param tag: тег сообщения. По умолчанию PARALLEL_STANDARD_TAG.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void ReceiveResizeIgnoreStatus(std::vector<T> &vec,
+                                      int from_rank = MPI_ANY_SOURCE,
+                                      int tag = PARALLEL_STANDARD_TAG,
+                                      MPI_Comm comm = MPI_COMM_WORLD,
+                                      bool need_print = false) {
+  MPI_Status status;
+  parallel::ReceiveResize(vec, mpi_type<T>::get(), status, from_rank, tag,
+                          comm, need_print);
+}
+
+/**
+ * @brief Дескриптор неблокирующей операции MPI (обёртка над MPI_Request).
+ * @details Объект можно только перемещать, но не копировать. Если к моменту
+ * уничтожения операция ещё не завершена, деструктор дожидается её
+ * завершения, чтобы буфер операции не был освобождён раньше времени.
+ */
+class Request {
+ public:
+  Request() : request_(MPI_REQUEST_NULL) {}
 
-  parallel::Broadcast(vec.data(), static_cast<int>(vec.size()), datatype,
-                      from_rank, comm);
+  explicit Request(MPI_Request request) : request_(request) {}
 
-  if (need_print) std::cout << "SUCCESS" << std::endl;
-}
+  Request(const Request &) = delete;
+  Request &operator=(const Request &) = delete;
+
+  Request(Request &&other) : request_(other.request_) {
+    other.request_ = MPI_REQUEST_NULL;
+  }
+
+  Request &operator=(Request &&other) {
+    if (this != &other) {
+      Wait();
+
+      request_ = other.request_;
+      other.request_ = MPI_REQUEST_NULL;
+    }
+
+    return *this;
+  }
+
+  ~Request() {
+    int is_finalized = 0;
+    MPI_Finalized(&is_finalized);
+
+    if (!is_finalized) Wait();
+  }
+
+  /**
+   * @brief Дожидается завершения операции.
+   * @param status: статус сообщения. По умолчанию MPI_STATUS_IGNORE.
+   */
+  void Wait(MPI_Status *status = MPI_STATUS_IGNORE) {
+    if (request_ != MPI_REQUEST_NULL)
+      parallel::CheckSuccess(MPI_Wait(&request_, status));
+  }
+
+  /**
+   * @brief Проверяет, завершена ли операция, не блокируя процесс.
+   * @param status: статус сообщения. По умолчанию MPI_STATUS_IGNORE.
+   * @return true, если операция завершена.
+   */
+  bool Test(MPI_Status *status = MPI_STATUS_IGNORE) {
+    if (request_ == MPI_REQUEST_NULL) return true;
+
+    int is_completed = 0;
+    parallel::CheckSuccess(MPI_Test(&request_, &is_completed, status));
+
+    return is_completed != 0;
+  }
+
+  /// @return true, если объект не связан с активной операцией MPI.
+  bool IsNull() const { return request_ == MPI_REQUEST_NULL; }
+
+  /// @return ссылка на хранимый MPI_Request.
+  MPI_Request &Handle() { return request_; }
+
+ private:
+  MPI_Request request_;
+};
 
 /**
- * @brief Выполняет операцию над значением и отправляет результат на
- * указанный процесс в сети MPI.
- * @tparam T: тип значения.
- * @param from_value: исходное значение, над которым выполняется операция.
- * @param to_value: значение, куда будет записан результат операции.
+ * @brief Начинает неблокирующую отправку значения по сети MPI.
+ * @tparam T: тип отправляемого значения.
+ * @param value: отправляемое значение (должно жить до завершения операции).
  * @param datatype: тип данных значения.
- * @param op: операция MPI, которая будет выполнена.
- * @param to_rank: ранг процесса результата. По умолчанию 0.
+ * @param to_rank: ранг получателя.
+ * @param tag: тег сообщения. По умолчанию PARALLEL_STANDARD_TAG.
  * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ * @return parallel::Request: дескриптор операции.
  */
 template <typename T>
-inline void Operation(const T &from_value, T &to_value, MPI_Datatype datatype,
-                      MPI_Op op, unsigned int to_rank = 0,
-                      MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
+inline Request ISend(const T &value, MPI_Datatype datatype,
+                     unsigned int to_rank, int tag = PARALLEL_STANDARD_TAG,
+                     MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
   if (need_print)
-    std::cout << "parallel::Operation with args: from_value: " << from_value
-              << "; to_value: " << to_value << "; datatype: " << datatype
-              << "; op: " << op << "; to_rank: " << to_rank
-              << "; comm: " << comm;
+    std::cout << "parallel::ISend with args: value: " << value
+              << "; datatype: " << datatype << "; to_rank: " << to_rank
+              << "; tag: " << tag << "; comm: " << comm;
 
+  MPI_Request request;
   parallel::CheckSuccess(
-      MPI_Reduce(&from_value, &to_value, 1, datatype, op, to_rank, comm));
+      MPI_Isend(&value, 1, datatype, to_rank, tag, comm, &request));
 
   if (need_print) std::cout << "SUCCESS" << std::endl;
+
+  return Request(request);
 }
 
 /**
- * @brief Выполняет операцию над массивом значений и отправляет результат на
- * указанный процесс в сети MPI.
- * @tparam T: тип значения в массиве.
- * @param from_arr: исходный массив значений, над которым выполняется операция.
- * @param to_arr: массив, куда будет записан результат операции.
+ * @brief Начинает неблокирующую отправку массива по сети MPI.
+ * @tparam T: тип элементов массива.
+ * @param arr: массив, который нужно отправить (должен жить до завершения
+ * операции).
  * @param arr_len: количество элементов в массиве.
  * @param datatype: тип данных элементов массива.
- * @param op: операция MPI, которая будет выполнена.
- * @param to_rank: ранг процесса результата. По умолчанию 0.
+ * @param to_rank: ранг получателя.
+ * @param tag: тег сообщения. По умолчанию PARALLEL_STANDARD_TAG.
  * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ * @return parallel::Request: дескриптор операции.
  */
 template <typename T>
-inline void Operation(const T *from_arr, T *to_arr, int arr_len,
-                      MPI_Datatype datatype, MPI_Op op,
-                      unsigned int to_rank = 0, MPI_Comm comm = MPI_COMM_WORLD,
-                      bool need_print = false) {
+inline Request ISend(const T *arr, int arr_len, MPI_Datatype datatype,
+                     unsigned int to_rank, int tag = PARALLEL_STANDARD_TAG,
+                     MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
   if (need_print)
-    std::cout << "parallel::Operation with args: from_arr: " << from_arr
-              << "; to_arr: " << to_arr << "; arr_len: " << arr_len
-              << "; datatype: " << datatype << "; op: " << op
-              << "; to_rank: " << to_rank << "; comm: " << comm;
+    std::cout << "parallel::ISend with args: arr: " << arr
+              << "; arr_len: " << arr_len << "; datatype: " << datatype
+              << "; to_rank: " << to_rank << "; tag: " << tag
+              << "; comm: " << comm;
 
   if (arr_len <= 0)
-    parallel::Error("parallel::Operation: arr_len should be non-negative.");
+    parallel::Error("parallel::ISend: arr_len should be non-negative.");
 
+  MPI_Request request;
   parallel::CheckSuccess(
-      MPI_Reduce(from_arr, to_arr, arr_len, datatype, op, to_rank, comm));
+      MPI_Isend(arr, arr_len, datatype, to_rank, tag, comm, &request));
 
   if (need_print) std::cout << "SUCCESS" << std::endl;
+
+  return Request(request);
 }
 
 /**
- * @brief Выполняет операцию над вектором значений и отправляет результат на
- * указанный процесс в сети MPI.
- * @tparam T: тип значения в векторе.
- * @param from_vec: исходный вектор значений, над которым выполняется операция.
- * @param to_vec: вектор, куда будет записан результат операции.
- * @param datatype: тип данных в векторе.
- * @param op: операция MPI, которая будет выполнена.
- * @param to_rank: ранг процесса результата. По умолчанию 0.
+ * @brief Начинает неблокирующую отправку вектора по сети MPI.
+ * @tparam T: тип элементов вектора.
+ * @param vec: вектор, который нужно отправить (должен жить и не менять
+ * размер до завершения операции).
+ * @param datatype: тип данных элементов вектора.
+ * @param to_rank: ранг получателя.
+ * @param tag: тег сообщения. По умолчанию PARALLEL_STANDARD_TAG.
  * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ * @return parallel::Request: дескриптор операции.
  */
 template <typename T>
-inline void Operation(const std::vector<T> &from_vec, std::vector<T> &to_vec,
-                      MPI_Datatype datatype, MPI_Op op,
-                      unsigned int to_rank = 0, MPI_Comm comm = MPI_COMM_WORLD,
-                      bool need_print = false) {
+inline Request ISend(const std::vector<T> &vec, MPI_Datatype datatype,
+                     unsigned int to_rank, int tag = PARALLEL_STANDARD_TAG,
+                     MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
   if (need_print)
-    std::cout << "parallel::Operation with args: from_vec: " << from_vec
-              << "; to_vec: " << to_vec << "; datatype: " << datatype
+    std::cout << "parallel::ISend with args: vec: " << vec
+              << "; datatype: " << datatype << "; to_rank: " << to_rank
+              << "; tag: " << tag << "; comm: " << comm;
+
+  if (vec.size() > INT_MAX)
+    parallel::Error("parallel::ISend: vector is too big (size > INT_MAX).");
+
+  Request request = parallel::ISend(vec.data(), static_cast<int>(vec.size()),
+                                    datatype, to_rank, tag, comm);
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+
+  return request;
+}
+
+/**
+ * @brief Начинает неблокирующее получение значения по сети MPI.
+ * @tparam T: тип получаемого значения.
+ * @param value: получаемое значение (должно жить до завершения операции).
+ * @param datatype: тип данных значения.
+ * @param from_rank: ранг отправителя. По умолчанию MPI_ANY_SOURCE.
+ * @param tag: тег сообщения. По умолчанию PARALLEL_STANDARD_TAG.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ * @return parallel::Request: дескриптор операции.
+ */
+template <typename T>
+inline Request IReceive(T &value, MPI_Datatype datatype,
+                        int from_rank = MPI_ANY_SOURCE,
+                        int tag = PARALLEL_STANDARD_TAG,
+                        MPI_Comm comm = MPI_COMM_WORLD,
+                        bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::IReceive with args: value: " << value
+              << "; datatype: " << datatype << "; from_rank: " << from_rank
+              << "; tag: " << tag << "; comm: " << comm;
+
+  MPI_Request request;
+  parallel::CheckSuccess(
+      MPI_Irecv(&value, 1, datatype, from_rank, tag, comm, &request));
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+
+  return Request(request);
+}
+
+/**
+ * @brief Начинает неблокирующее получение массива по сети MPI.
+ * @tparam T: тип элементов массива.
+ * @param arr: массив, в который нужно получить данные (должен жить до
+ * завершения операции).
+ * @param arr_len: количество элементов в массиве.
+ * @param datatype: тип данных элементов массива.
+ * @param from_rank: ранг отправителя. По умолчанию MPI_ANY_SOURCE.
+ * @param tag: тег сообщения. По умолчанию PARALLEL_STANDARD_TAG.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ * @return parallel::Request: дескриптор операции.
+ */
+template <typename T>
+inline Request IReceive(T *arr, int arr_len, MPI_Datatype datatype,
+                        int from_rank = MPI_ANY_SOURCE,
+                        int tag = PARALLEL_STANDARD_TAG,
+                        MPI_Comm comm = MPI_COMM_WORLD,
+                        bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::IReceive with args: arr: " << arr
+              << "; arr_len: " << arr_len << "; datatype: " << datatype
+              << "; from_rank: " << from_rank << "; tag: " << tag
+              << "; comm: " << comm;
+
+  if (arr_len <= 0)
+    parallel::Error("parallel::IReceive: arr_len should be non-negative.");
+
+  MPI_Request request;
+  parallel::CheckSuccess(
+      MPI_Irecv(arr, arr_len, datatype, from_rank, tag, comm, &request));
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+
+  return Request(request);
+}
+
+/**
+ * @brief Начинает неблокирующее получение вектора по сети MPI.
+ * @tparam T: тип элементов вектора.
+ * @param vec: вектор, в который нужно получить данные (должен жить и не
+ * менять размер до завершения операции).
+ * @param datatype: тип данных элементов вектора.
+ * @param from_rank: ранг отправителя. По умолчанию MPI_ANY_SOURCE.
+ * @param tag: тег сообщения. По умолчанию PARALLEL_STANDARD_TAG.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ * @return parallel::Request: дескриптор операции.
+ */
+template <typename T>
+inline Request IReceive(std::vector<T> &vec, MPI_Datatype datatype,
+                        int from_rank = MPI_ANY_SOURCE,
+                        int tag = PARALLEL_STANDARD_TAG,
+                        MPI_Comm comm = MPI_COMM_WORLD,
+                        bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::IReceive with args: vec: " << vec
+              << "; datatype: " << datatype << "; from_rank: " << from_rank
+              << "; tag: " << tag << "; comm: " << comm;
+
+  if (vec.size() > INT_MAX)
+    parallel::Error("parallel::IReceive: vector is too big (size > INT_MAX).");
+
+  Request request = parallel::IReceive(
+      vec.data(), static_cast<int>(vec.size()), datatype, from_rank, tag, comm);
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+
+  return request;
+}
+
+/**
+ * @brief Дожидается завершения всех неблокирующих операций.
+ * @param requests: массив дескрипторов операций.
+ * @param requests_len: количество элементов в массиве.
+ */
+inline void WaitAll(Request *requests, int requests_len,
+                    bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::WaitAll with args: requests: " << requests
+              << "; requests_len: " << requests_len;
+
+  if (requests_len < 0)
+    parallel::Error("parallel::WaitAll: requests_len should be non-negative.");
+
+  PooledBuffer<MPI_Request> handles(requests_len);
+  for (int i = 0; i < requests_len; i++) handles[i] = requests[i].Handle();
+
+  parallel::CheckSuccess(
+      MPI_Waitall(requests_len, handles.Data(), MPI_STATUSES_IGNORE));
+
+  for (int i = 0; i < requests_len; i++) requests[i].Handle() = handles[i];
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Дожидается завершения всех неблокирующих операций.
+ * @param requests: вектор дескрипторов операций.
+ */
+inline void WaitAll(std::vector<Request> &requests, bool need_print = false) {
+  if (requests.size() > INT_MAX)
+    parallel::Error("parallel::WaitAll: vector is too big (size > INT_MAX).");
+
+  parallel::WaitAll(requests.data(), static_cast<int>(requests.size()),
+                    need_print);
+}
+
+/**
+ * @brief Дожидается завершения любой из неблокирующих операций.
+ * @param requests: массив дескрипторов операций.
+ * @param requests_len: количество элементов в массиве.
+ * @return int: индекс завершённой операции или MPI_UNDEFINED, если активных
+ * операций нет.
+ */
+inline int WaitAny(Request *requests, int requests_len,
+                   bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::WaitAny with args: requests: " << requests
+              << "; requests_len: " << requests_len;
+
+  if (requests_len < 0)
+    parallel::Error("parallel::WaitAny: requests_len should be non-negative.");
+
+  PooledBuffer<MPI_Request> handles(requests_len);
+  for (int i = 0; i < requests_len; i++) handles[i] = requests[i].Handle();
+
+  int index = MPI_UNDEFINED;
+  parallel::CheckSuccess(
+      MPI_Waitany(requests_len, handles.Data(), &index, MPI_STATUS_IGNORE));
+
+  if (index != MPI_UNDEFINED) requests[index].Handle() = handles[index];
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+
+  return index;
+}
+
+/**
+ * @brief Дожидается завершения любой из неблокирующих операций.
+ * @param requests: вектор дескрипторов операций.
+ * @return int: индекс завершённой операции или MPI_UNDEFINED, если активных
+ * операций нет.
+ */
+inline int WaitAny(std::vector<Request> &requests, bool need_print = false) {
+  if (requests.size() > INT_MAX)
+    parallel::Error("parallel::WaitAny: vector is too big (size > INT_MAX).");
+
+  return parallel::WaitAny(requests.data(), static_cast<int>(requests.size()),
+                           need_print);
+}
+
+/**
+ * @brief Проверяет, завершены ли все неблокирующие операции, не блокируя
+ * процесс.
+ * @param requests: массив дескрипторов операций.
+ * @param requests_len: количество элементов в массиве.
+ * @return true, если все операции завершены.
+ */
+inline bool TestAll(Request *requests, int requests_len,
+                    bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::TestAll with args: requests: " << requests
+              << "; requests_len: " << requests_len;
+
+  if (requests_len < 0)
+    parallel::Error("parallel::TestAll: requests_len should be non-negative.");
+
+  PooledBuffer<MPI_Request> handles(requests_len);
+  for (int i = 0; i < requests_len; i++) handles[i] = requests[i].Handle();
+
+  int is_completed = 0;
+  parallel::CheckSuccess(MPI_Testall(requests_len, handles.Data(),
+                                     &is_completed, MPI_STATUSES_IGNORE));
+
+  if (is_completed)
+    for (int i = 0; i < requests_len; i++) requests[i].Handle() = handles[i];
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+
+  return is_completed != 0;
+}
+
+/**
+ * @brief Проверяет, завершены ли все неблокирующие операции, не блокируя
+ * процесс.
+ * @param requests: вектор дескрипторов операций.
+ * @return true, если все операции завершены.
+ */
+inline bool TestAll(std::vector<Request> &requests, bool need_print = false) {
+  if (requests.size() > INT_MAX)
+    parallel::Error("parallel::TestAll: vector is too big (size > INT_MAX).");
+
+  return parallel::TestAll(requests.data(), static_cast<int>(requests.size()),
+                           need_print);
+}
+
+/**
+ * @brief Набор постоянных (persistent) операций обмена сообщениями.
+ * @details Операции создаются один раз через MPI_Send_init/MPI_Recv_init и
+ * затем многократно запускаются методом Start и завершаются методом Wait,
+ * что убирает затраты на подготовку каждого сообщения в итерационных
+ * схемах.
+ *
+ * Каждая операция хранится в двух вариантах: для исходного расположения
+ * буферов и для расположения после std::swap(U, U_new). Метод Swap
+ * переключает используемый вариант и должен вызываться вместе с обменом
+ * буферов. Если буфер один и тот же, его адрес передаётся один раз.
+ */
+class PersistentExchange {
+ public:
+  PersistentExchange() : curr_state_(0), is_started_(false) {}
+
+  PersistentExchange(const PersistentExchange &) = delete;
+  PersistentExchange &operator=(const PersistentExchange &) = delete;
+
+  PersistentExchange(PersistentExchange &&other)
+      : curr_state_(other.curr_state_), is_started_(other.is_started_) {
+    for (int i = 0; i < 2; i++) requests_[i].swap(other.requests_[i]);
+
+    other.is_started_ = false;
+  }
+
+  ~PersistentExchange() {
+    int is_finalized = 0;
+    MPI_Finalized(&is_finalized);
+
+    if (is_finalized) return;
+
+    Wait();
+
+    for (int i = 0; i < 2; i++)
+      for (std::size_t j = 0; j < requests_[i].size(); j++)
+        if (requests_[i][j] != MPI_REQUEST_NULL)
+          MPI_Request_free(&requests_[i][j]);
+  }
+
+  /**
+   * @brief Добавляет постоянную отправку массива.
+   * @tparam T: тип элементов массива.
+   * @param arr: массив, который нужно отправлять.
+   * @param swapped_arr: тот же массив после обмена буферов.
+   * @param arr_len: количество элементов в массиве.
+   * @param datatype: тип данных элементов массива.
+   * @param to_rank: ранг получателя (допускается MPI_PROC_NULL).
+   * @param tag: тег сообщения. По умолчанию PARALLEL_STANDARD_TAG.
+   * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+   */
+  template <typename T>
+  void AddSend(const T *arr, const T *swapped_arr, int arr_len,
+               MPI_Datatype datatype, int to_rank,
+               int tag = PARALLEL_STANDARD_TAG,
+               MPI_Comm comm = MPI_COMM_WORLD) {
+    if (arr_len <= 0)
+      parallel::Error(
+          "parallel::PersistentExchange::AddSend: arr_len should be "
+          "non-negative.");
+
+    const T *arrs[2] = {arr, swapped_arr};
+
+    for (int i = 0; i < 2; i++) {
+      MPI_Request request;
+      parallel::CheckSuccess(MPI_Send_init(arrs[i], arr_len, datatype, to_rank,
+                                           tag, comm, &request));
+
+      requests_[i].push_back(request);
+    }
+  }
+
+  /**
+   * @brief Добавляет постоянную отправку массива, адрес которого не меняется.
+   * @tparam T: тип элементов массива.
+   * @param arr: массив, который нужно отправлять.
+   * @param arr_len: количество элементов в массиве.
+   * @param datatype: тип данных элементов массива.
+   * @param to_rank: ранг получателя (допускается MPI_PROC_NULL).
+   * @param tag: тег сообщения. По умолчанию PARALLEL_STANDARD_TAG.
+   * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+   */
+  template <typename T>
+  void AddSend(const T *arr, int arr_len, MPI_Datatype datatype, int to_rank,
+               int tag = PARALLEL_STANDARD_TAG,
+               MPI_Comm comm = MPI_COMM_WORLD) {
+    AddSend(arr, arr, arr_len, datatype, to_rank, tag, comm);
+  }
+
+  /**
+   * @brief Добавляет постоянное получение массива.
+   * @tparam T: тип элементов массива.
+   * @param arr: массив, в который нужно получать данные.
+   * @param swapped_arr: тот же массив после обмена буферов.
+   * @param arr_len: количество элементов в массиве.
+   * @param datatype: тип данных элементов массива.
+   * @param from_rank: ранг отправителя (допускается MPI_PROC_NULL).
+   * @param tag: тег сообщения. По умолчанию PARALLEL_STANDARD_TAG.
+   * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+   */
+  template <typename T>
+  void AddReceive(T *arr, T *swapped_arr, int arr_len, MPI_Datatype datatype,
+                  int from_rank, int tag = PARALLEL_STANDARD_TAG,
+                  MPI_Comm comm = MPI_COMM_WORLD) {
+    if (arr_len <= 0)
+      parallel::Error(
+          "parallel::PersistentExchange::AddReceive: arr_len should be "
+          "non-negative.");
+
+    T *arrs[2] = {arr, swapped_arr};
+
+    for (int i = 0; i < 2; i++) {
+      MPI_Request request;
+      parallel::CheckSuccess(MPI_Recv_init(arrs[i], arr_len, datatype,
+                                           from_rank, tag, comm, &request));
+
+      requests_[i].push_back(request);
+    }
+  }
+
+  /**
+   * @brief Добавляет постоянное получение массива, адрес которого не
+   * меняется.
+   * @tparam T: тип элементов массива.
+   * @param arr: массив, в который нужно получать данные.
+   * @param arr_len: количество элементов в массиве.
+   * @param datatype: тип данных элементов массива.
+   * @param from_rank: ранг отправителя (допускается MPI_PROC_NULL).
+   * @param tag: тег сообщения. По умолчанию PARALLEL_STANDARD_TAG.
+   * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+   */
+  template <typename T>
+  void AddReceive(T *arr, int arr_len, MPI_Datatype datatype, int from_rank,
+                  int tag = PARALLEL_STANDARD_TAG,
+                  MPI_Comm comm = MPI_COMM_WORLD) {
+    AddReceive(arr, arr, arr_len, datatype, from_rank, tag, comm);
+  }
+
+  /// @brief Запускает все операции для текущего расположения буферов.
+  void Start() {
+    if (is_started_)
+      parallel::Error(
+          "parallel::PersistentExchange::Start: exchange is already started.");
+
+    std::vector<MPI_Request> &requests = requests_[curr_state_];
+
+    if (requests.size() > INT_MAX)
+      parallel::Error(
+          "parallel::PersistentExchange::Start: too many requests (size > "
+          "INT_MAX).");
+
+    if (!requests.empty())
+      parallel::CheckSuccess(
+          MPI_Startall(static_cast<int>(requests.size()), requests.data()));
+
+    is_started_ = true;
+  }
+
+  /// @brief Дожидается завершения всех запущенных операций.
+  void Wait() {
+    if (!is_started_) return;
+
+    std::vector<MPI_Request> &requests = requests_[curr_state_];
+
+    if (!requests.empty())
+      parallel::CheckSuccess(MPI_Waitall(static_cast<int>(requests.size()),
+                                         requests.data(),
+                                         MPI_STATUSES_IGNORE));
+
+    is_started_ = false;
+  }
+
+  /**
+   * @brief Проверяет, завершены ли все запущенные операции, не блокируя
+   * процесс.
+   * @return true, если все операции завершены (или не были запущены).
+   */
+  bool Test() {
+    if (!is_started_) return true;
+
+    std::vector<MPI_Request> &requests = requests_[curr_state_];
+
+    int is_completed = 1;
+    if (!requests.empty())
+      parallel::CheckSuccess(MPI_Testall(static_cast<int>(requests.size()),
+                                         requests.data(), &is_completed,
+                                         MPI_STATUSES_IGNORE));
+
+    if (is_completed) is_started_ = false;
+
+    return is_completed != 0;
+  }
+
+  /**
+   * @brief Переключает расположение буферов (вызывается вместе с
+   * std::swap(U, U_new)).
+   */
+  void Swap() {
+    if (is_started_)
+      parallel::Error(
+          "parallel::PersistentExchange::Swap: exchange is not completed.");
+
+    curr_state_ = 1 - curr_state_;
+  }
+
+ private:
+  std::vector<MPI_Request> requests_[2];
+  int curr_state_;
+  bool is_started_;
+};
+
+/**
+ * @brief Одновременно отправляет и получает значение по сети MPI
+ * (без взаимной блокировки процессов).
+ * @tparam T: тип значений.
+ * @param send_value: отправляемое значение.
+ * @param recv_value: получаемое значение.
+ * @param datatype: тип данных значений.
+ * @param to_rank: ранг получателя (допускается MPI_PROC_NULL).
+ * @param from_rank: ранг отправителя (допускается MPI_PROC_NULL).
+ * @param tag: тег сообщения. По умолчанию PARALLEL_STANDARD_TAG.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void SendReceive(const T &send_value, T &recv_value,
+                        MPI_Datatype datatype, int to_rank, int from_rank,
+                        int tag = PARALLEL_STANDARD_TAG,
+                        MPI_Comm comm = MPI_COMM_WORLD,
+                        bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::SendReceive with args: send_value: " << send_value
+              << "; recv_value: " << recv_value << "; datatype: " << datatype
+              << "; to_rank: " << to_rank << "; from_rank: " << from_rank
+              << "; tag: " << tag << "; comm: " << comm;
+
+  parallel::CheckSuccess(MPI_Sendrecv(&send_value, 1, datatype, to_rank, tag,
+                                      &recv_value, 1, datatype, from_rank, tag,
+                                      comm, MPI_STATUS_IGNORE));
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Одновременно отправляет и получает массив по сети MPI
+ * (без взаимной блокировки процессов).
+ * @tparam T: тип элементов массивов.
+ * @param send_arr: отправляемый массив.
+ * @param send_arr_len: количество элементов в массиве `send_arr`.
+ * @param recv_arr: массив, в который нужно получить данные.
+ * @param recv_arr_len: количество элементов в массиве `recv_arr`.
+ * @param datatype: тип данных элементов массивов.
+ * @param to_rank: ранг получателя (допускается MPI_PROC_NULL).
+ * @param from_rank: ранг отправителя (допускается MPI_PROC_NULL).
+ * @param tag: тег сообщения. По умолчанию PARALLEL_STANDARD_TAG.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void SendReceive(const T *send_arr, int send_arr_len, T *recv_arr,
+                        int recv_arr_len, MPI_Datatype datatype, int to_rank,
+                        int from_rank, int tag = PARALLEL_STANDARD_TAG,
+                        MPI_Comm comm = MPI_COMM_WORLD,
+                        bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::SendReceive with args: send_arr: " << send_arr
+              << "; send_arr_len: " << send_arr_len
+              << "; recv_arr: " << recv_arr
+              << "; recv_arr_len: " << recv_arr_len
+              << "; datatype: " << datatype << "; to_rank: " << to_rank
+              << "; from_rank: " << from_rank << "; tag: " << tag
+              << "; comm: " << comm;
+
+  if (send_arr_len < 0 || recv_arr_len < 0)
+    parallel::Error("parallel::SendReceive: arr_len should be non-negative.");
+
+  parallel::CheckSuccess(MPI_Sendrecv(send_arr, send_arr_len, datatype, to_rank,
+                                      tag, recv_arr, recv_arr_len, datatype,
+                                      from_rank, tag, comm,
+                                      MPI_STATUS_IGNORE));
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Одновременно отправляет и получает вектор по сети MPI
+ * (без взаимной блокировки процессов).
+ * @tparam T: тип элементов векторов.
+ * @param send_vec: отправляемый вектор.
+ * @param recv_vec: вектор, в который нужно получить данные.
+ * @param datatype: тип данных элементов векторов.
+ * @param to_rank: ранг получателя (допускается MPI_PROC_NULL).
+ * @param from_rank: ранг отправителя (допускается MPI_PROC_NULL).
+ * @param tag: тег сообщения. По умолчанию PARALLEL_STANDARD_TAG.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void SendReceive(const std::vector<T> &send_vec,
+                        std::vector<T> &recv_vec, MPI_Datatype datatype,
+                        int to_rank, int from_rank,
+                        int tag = PARALLEL_STANDARD_TAG,
+                        MPI_Comm comm = MPI_COMM_WORLD,
+                        bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::SendReceive with args: send_vec: " << send_vec
+              << "; recv_vec: " << recv_vec << "; datatype: " << datatype
+              << "; to_rank: " << to_rank << "; from_rank: " << from_rank
+              << "; tag: " << tag << "; comm: " << comm;
+
+  if (send_vec.size() > INT_MAX || recv_vec.size() > INT_MAX)
+    parallel::Error(
+        "parallel::SendReceive: vector is too big (size > INT_MAX).");
+
+  parallel::SendReceive(send_vec.data(), static_cast<int>(send_vec.size()),
+                        recv_vec.data(), static_cast<int>(recv_vec.size()),
+                        datatype, to_rank, from_rank, tag, comm);
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Обменивается граничными значениями с соседями в одномерном
+ * разбиении (процессы `curr_rank - 1` и `curr_rank + 1`).
+ * @details Обмен выполняется двумя сдвигами через MPI_Sendrecv, поэтому все
+ * процессы обмениваются одновременно, а не по цепочке, и корректность не
+ * зависит от буферизации сообщений. На концах области вместо соседа
+ * используется MPI_PROC_NULL, и соответствующая теневая ячейка не меняется.
+ * @tparam T: тип значений.
+ * @param left_ghost: теневая ячейка слева (получает `right_edge` соседа слева).
+ * @param left_edge: крайняя левая ячейка текущего процесса.
+ * @param right_edge: крайняя правая ячейка текущего процесса.
+ * @param right_ghost: теневая ячейка справа (получает `left_edge` соседа
+ * справа).
+ * @param datatype: тип данных значений.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ * @param tag: тег сообщения. По умолчанию PARALLEL_STANDARD_TAG.
+ */
+template <typename T>
+inline void ShiftHalo(T &left_ghost, const T &left_edge, const T &right_edge,
+                      T &right_ghost, MPI_Datatype datatype,
+                      MPI_Comm comm = MPI_COMM_WORLD,
+                      int tag = PARALLEL_STANDARD_TAG,
+                      bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::ShiftHalo with args: left_ghost: " << left_ghost
+              << "; left_edge: " << left_edge
+              << "; right_edge: " << right_edge
+              << "; right_ghost: " << right_ghost
+              << "; datatype: " << datatype << "; comm: " << comm
+              << "; tag: " << tag;
+
+  int ranks_amount = parallel::RanksAmount(comm);
+  int curr_rank = parallel::CurrRank(comm);
+
+  int left_rank = curr_rank > 0 ? curr_rank - 1 : MPI_PROC_NULL;
+  int right_rank =
+      curr_rank < ranks_amount - 1 ? curr_rank + 1 : MPI_PROC_NULL;
+
+  // сдвиг вправо: правый край уходит правому соседу, слева приходит его край
+  parallel::SendReceive(right_edge, left_ghost, datatype, right_rank, left_rank,
+                        tag, comm);
+
+  // сдвиг влево: левый край уходит левому соседу, справа приходит его край
+  parallel::SendReceive(left_edge, right_ghost, datatype, left_rank, right_rank,
+                        tag, comm);
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Возвращает коммуникатор процессов comm, работающих на том же узле
+ * (с общей памятью), создавая его при первом запросе.
+ * @details Коммуникаторы создаются через MPI_Comm_split_type
+ * (MPI_COMM_TYPE_SHARED), кэшируются по comm и живут до завершения работы с
+ * MPI.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ * @return MPI_Comm: коммуникатор узла.
+ */
+inline MPI_Comm NodeComm(MPI_Comm comm = MPI_COMM_WORLD,
+                         bool need_print = false) {
+  static std::map<MPI_Comm, MPI_Comm> cache;
+  static std::mutex cache_mutex;
+
+  if (need_print)
+    std::cout << "parallel::NodeComm with args: comm: " << comm << "; ";
+
+  std::lock_guard<std::mutex> lock(cache_mutex);
+
+  auto it = cache.find(comm);
+  if (it != cache.end()) {
+    if (need_print) std::cout << "SUCCESS" << std::endl;
+    return it->second;
+  }
+
+  MPI_Comm node_comm;
+  parallel::CheckSuccess(MPI_Comm_split_type(
+      comm, MPI_COMM_TYPE_SHARED, parallel::CurrRank(comm), MPI_INFO_NULL,
+      &node_comm));
+
+  cache[comm] = node_comm;
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+
+  return node_comm;
+}
+
+/**
+ * @brief Локальная часть распределённого массива, размещённая в общей памяти
+ * узла (MPI_Win_allocate_shared).
+ * @details Каждый процесс владеет своим сегментом, но может напрямую читать
+ * сегменты процессов того же узла (NodeData), без копирования через
+ * MPI_Send/MPI_Recv. Окно всё время существования объекта открыто в режиме
+ * MPI_Win_lock_all, видимость записей между процессами узла обеспечивает
+ * метод Sync. Объект можно только перемещать, но не копировать; создание и
+ * уничтожение - коллективные операции над comm.
+ * @tparam T: тип элементов.
+ */
+template <typename T>
+class SharedArray {
+ public:
+  /**
+   * @param size: количество элементов в сегменте текущего процесса.
+   * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+   */
+  explicit SharedArray(std::size_t size, MPI_Comm comm = MPI_COMM_WORLD)
+      : comm_(comm), node_comm_(parallel::NodeComm(comm)), size_(size) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "parallel::SharedArray: T should be trivially copyable.");
+
+    parallel::CheckSuccess(MPI_Win_allocate_shared(
+        static_cast<MPI_Aint>(size * sizeof(T)), sizeof(T), MPI_INFO_NULL,
+        node_comm_, &data_, &window_));
+
+    parallel::CheckSuccess(MPI_Win_lock_all(MPI_MODE_NOCHECK, window_));
+
+    // соответствие рангов comm рангам узла (MPI_UNDEFINED - другой узел)
+    int ranks_amount = parallel::RanksAmount(comm_);
+    std::vector<int> ranks(ranks_amount);
+    for (int i = 0; i < ranks_amount; i++) ranks[i] = i;
+
+    node_ranks_.resize(ranks_amount);
+
+    MPI_Group group, node_group;
+    parallel::CheckSuccess(MPI_Comm_group(comm_, &group));
+    parallel::CheckSuccess(MPI_Comm_group(node_comm_, &node_group));
+    parallel::CheckSuccess(MPI_Group_translate_ranks(
+        group, ranks_amount, ranks.data(), node_group, node_ranks_.data()));
+    parallel::CheckSuccess(MPI_Group_free(&group));
+    parallel::CheckSuccess(MPI_Group_free(&node_group));
+  }
+
+  SharedArray(const SharedArray &) = delete;
+  SharedArray &operator=(const SharedArray &) = delete;
+
+  SharedArray(SharedArray &&other)
+      : comm_(other.comm_),
+        node_comm_(other.node_comm_),
+        window_(other.window_),
+        data_(other.data_),
+        size_(other.size_),
+        node_ranks_(std::move(other.node_ranks_)) {
+    other.window_ = MPI_WIN_NULL;
+    other.data_ = nullptr;
+    other.size_ = 0;
+  }
+
+  SharedArray &operator=(SharedArray &&other) {
+    if (this != &other) {
+      Free();
+
+      comm_ = other.comm_;
+      node_comm_ = other.node_comm_;
+      window_ = other.window_;
+      data_ = other.data_;
+      size_ = other.size_;
+      node_ranks_ = std::move(other.node_ranks_);
+
+      other.window_ = MPI_WIN_NULL;
+      other.data_ = nullptr;
+      other.size_ = 0;
+    }
+
+    return *this;
+  }
+
+  ~SharedArray() { Free(); }
+
+  T *Data() { return data_; }
+  const T *Data() const { return data_; }
+
+  std::size_t Size() const { return size_; }
+
+  T &operator[](std::size_t index) { return data_[index]; }
+  const T &operator[](std::size_t index) const { return data_[index]; }
+
+  MPI_Comm Comm() const { return comm_; }
+
+  MPI_Win Window() const { return window_; }
+
+  /**
+   * @param rank: ранг процесса в comm.
+   * @return int: ранг этого процесса в коммуникаторе узла или
+   * MPI_UNDEFINED, если процесс работает на другом узле.
+   */
+  int NodeRank(int rank) const { return node_ranks_[rank]; }
+
+  /**
+   * @brief Возвращает сегмент процесса того же узла.
+   * @param node_rank: ранг процесса в коммуникаторе узла.
+   * @param size: количество элементов в сегменте (выходной параметр).
+   * @return T*: начало сегмента.
+   */
+  T *NodeData(int node_rank, std::size_t &size) const {
+    MPI_Aint bytes;
+    int disp_unit;
+    T *data;
+
+    parallel::CheckSuccess(
+        MPI_Win_shared_query(window_, node_rank, &bytes, &disp_unit, &data));
+
+    size = static_cast<std::size_t>(bytes) / sizeof(T);
+
+    return data;
+  }
+
+  /**
+   * @brief Делает записи всех процессов узла в их сегменты видимыми
+   * остальным процессам узла (MPI_Win_sync + MPI_Barrier).
+   */
+  void Sync() {
+    parallel::CheckSuccess(MPI_Win_sync(window_));
+    parallel::CheckSuccess(MPI_Barrier(node_comm_));
+    parallel::CheckSuccess(MPI_Win_sync(window_));
+  }
+
+ private:
+  void Free() {
+    if (window_ == MPI_WIN_NULL) return;
+
+    int is_finalized = 0;
+    MPI_Finalized(&is_finalized);
+
+    if (!is_finalized) {
+      MPI_Win_unlock_all(window_);
+      MPI_Win_free(&window_);
+    }
+
+    window_ = MPI_WIN_NULL;
+  }
+
+  MPI_Comm comm_;
+  MPI_Comm node_comm_;
+  MPI_Win window_ = MPI_WIN_NULL;
+  T *data_ = nullptr;
+  std::size_t size_;
+  std::vector<int> node_ranks_;
+};
+
+/**
+ * @brief Обменивается граничными ячейками сегментов SharedArray с соседями
+ * по одномерной декомпозиции (ранги curr_rank - 1 и curr_rank + 1 в comm).
+ * @details Сегмент устроен как [левая фиктивная ячейка, левый край, ...,
+ * правый край, правая фиктивная ячейка]. Края соседей того же узла читаются
+ * напрямую из общей памяти, по сети (MPI_Sendrecv) передаются только
+ * границы между узлами, а соседи на узле лишь попарно уведомляют друг друга
+ * пустыми сообщениями. У крайних процессов соответствующая фиктивная ячейка
+ * не меняется.
+ *
+ * Соседи читают края во время вызова, поэтому до следующей записи в края
+ * этого же массива процессы должны синхронизироваться: достаточно чередовать
+ * два массива (U и U_new) или вызвать Sync.
+ * @tparam T: тип элементов.
+ * @param arr: сегмент массива (не меньше 2 элементов).
+ * @param datatype: тип данных MPI.
+ * @param tag: тег сообщений. По умолчанию PARALLEL_STANDARD_TAG.
+ */
+template <typename T>
+inline void ShiftHalo(SharedArray<T> &arr, MPI_Datatype datatype,
+                      int tag = PARALLEL_STANDARD_TAG,
+                      bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::ShiftHalo with args: arr: " << arr.Data()
+              << "; datatype: " << datatype << "; tag: " << tag << "; ";
+
+  std::size_t size = arr.Size();
+
+  if (size < 2)
+    parallel::Error("parallel::ShiftHalo: segment should have ghost cells.");
+
+  MPI_Comm comm = arr.Comm();
+
+  int ranks_amount = parallel::RanksAmount(comm);
+  int curr_rank = parallel::CurrRank(comm);
+
+  int left_rank = curr_rank > 0 ? curr_rank - 1 : MPI_PROC_NULL;
+  int right_rank =
+      curr_rank < ranks_amount - 1 ? curr_rank + 1 : MPI_PROC_NULL;
+
+  int left_node_rank =
+      left_rank != MPI_PROC_NULL ? arr.NodeRank(left_rank) : MPI_UNDEFINED;
+  int right_node_rank =
+      right_rank != MPI_PROC_NULL ? arr.NodeRank(right_rank) : MPI_UNDEFINED;
+
+  // соседям на других узлах отправляется край, соседям на том же узле -
+  // пустое сообщение-уведомление о том, что их край уже записан
+  int left_len = left_node_rank == MPI_UNDEFINED ? 1 : 0;
+  int right_len = right_node_rank == MPI_UNDEFINED ? 1 : 0;
+
+  parallel::CheckSuccess(MPI_Win_sync(arr.Window()));
+
+  parallel::SendReceive(&arr[size - 2], right_len, &arr[0], left_len, datatype,
+                        right_rank, left_rank, tag, comm);
+  parallel::SendReceive(&arr[1], left_len, &arr[size - 1], right_len, datatype,
+                        left_rank, right_rank, tag, comm);
+
+  parallel::CheckSuccess(MPI_Win_sync(arr.Window()));
+
+  std::size_t neighbor_size;
+
+  if (left_node_rank != MPI_UNDEFINED) {
+    const T *left = arr.NodeData(left_node_rank, neighbor_size);
+    arr[0] = left[neighbor_size - 2];
+  }
+
+  if (right_node_rank != MPI_UNDEFINED) {
+    const T *right = arr.NodeData(right_node_rank, neighbor_size);
+    arr[size - 1] = right[1];
+  }
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Обменивается граничными ячейками сегментов SharedArray с соседями
+ * по одномерной декомпозиции (тип данных MPI выводится из T).
+ * @tparam T: тип элементов.
+ * @param arr: сегмент массива (не меньше 2 элементов).
+ * @param tag: тег сообщений. По умолчанию PARALLEL_STANDARD_TAG.
+ */
+template <typename T>
+inline void ShiftHalo(SharedArray<T> &arr, int tag = PARALLEL_STANDARD_TAG,
+                      bool need_print = false) {
+  parallel::ShiftHalo(arr, mpi_type<T>::get(), tag, need_print);
+}
+
+/**
+ * @brief Окно односторонних обменов MPI (RMA) над массивом процесса.
+ * @details Память либо выделяется самим окном (MPI_Win_allocate), либо
+ * принадлежит пользователю (MPI_Win_create). Смещения в Put/Get/Accumulate
+ * задаются в элементах массива получателя. Поддерживаются оба режима
+ * синхронизации: активный (Fence) и пассивный (LockAll, Flush, FlushAll,
+ * UnlockAll). Объект можно только перемещать, но не копировать; создание и
+ * уничтожение - коллективные операции над comm.
+ * @tparam T: тип элементов.
+ */
+template <typename T>
+class Window {
+ public:
+  /**
+   * @brief Выделяет массив вместе с окном.
+   * @param size: количество элементов в массиве текущего процесса.
+   * @param datatype: тип данных MPI элементов. По умолчанию выводится из T.
+   * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+   */
+  explicit Window(std::size_t size, MPI_Datatype datatype = mpi_type<T>::get(),
+                  MPI_Comm comm = MPI_COMM_WORLD)
+      : comm_(comm), datatype_(datatype), size_(size) {
+    parallel::CheckSuccess(MPI_Win_allocate(
+        static_cast<MPI_Aint>(size * sizeof(T)), sizeof(T), MPI_INFO_NULL,
+        comm_, &data_, &window_));
+
+    GatherSizes();
+  }
+
+  /**
+   * @brief Открывает окно над уже существующим массивом (массив должен жить
+   * дольше окна).
+   * @param data: массив текущего процесса.
+   * @param size: количество элементов в массиве.
+   * @param datatype: тип данных MPI элементов. По умолчанию выводится из T.
+   * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+   */
+  Window(T *data, std::size_t size, MPI_Datatype datatype = mpi_type<T>::get(),
+         MPI_Comm comm = MPI_COMM_WORLD)
+      : comm_(comm), datatype_(datatype), data_(data), size_(size) {
+    parallel::CheckSuccess(
+        MPI_Win_create(data_, static_cast<MPI_Aint>(size * sizeof(T)),
+                       sizeof(T), MPI_INFO_NULL, comm_, &window_));
+
+    GatherSizes();
+  }
+
+  Window(const Window &) = delete;
+  Window &operator=(const Window &) = delete;
+
+  Window(Window &&other)
+      : comm_(other.comm_),
+        datatype_(other.datatype_),
+        window_(other.window_),
+        data_(other.data_),
+        size_(other.size_),
+        sizes_(std::move(other.sizes_)),
+        is_locked_(other.is_locked_) {
+    other.window_ = MPI_WIN_NULL;
+    other.data_ = nullptr;
+    other.size_ = 0;
+    other.is_locked_ = false;
+  }
+
+  Window &operator=(Window &&other) {
+    if (this != &other) {
+      Free();
+
+      comm_ = other.comm_;
+      datatype_ = other.datatype_;
+      window_ = other.window_;
+      data_ = other.data_;
+      size_ = other.size_;
+      sizes_ = std::move(other.sizes_);
+      is_locked_ = other.is_locked_;
+
+      other.window_ = MPI_WIN_NULL;
+      other.data_ = nullptr;
+      other.size_ = 0;
+      other.is_locked_ = false;
+    }
+
+    return *this;
+  }
+
+  ~Window() { Free(); }
+
+  T *Data() { return data_; }
+  const T *Data() const { return data_; }
+
+  std::size_t Size() const { return size_; }
+
+  /**
+   * @param rank: ранг процесса в comm.
+   * @return std::size_t: количество элементов в массиве этого процесса.
+   */
+  std::size_t Size(int rank) const { return sizes_[rank]; }
+
+  T &operator[](std::size_t index) { return data_[index]; }
+  const T &operator[](std::size_t index) const { return data_[index]; }
+
+  MPI_Comm Comm() const { return comm_; }
+
+  MPI_Win Handle() const { return window_; }
+
+  /**
+   * @brief Записывает массив в окно процесса to_rank.
+   * @param arr: массив, который нужно записать.
+   * @param arr_len: количество элементов в массиве.
+   * @param to_rank: ранг получателя.
+   * @param disp: смещение (в элементах) в массиве получателя.
+   */
+  void Put(const T *arr, int arr_len, int to_rank, MPI_Aint disp) {
+    if (arr_len < 0)
+      parallel::Error("parallel::Window::Put: arr_len should be non-negative.");
+
+    parallel::CheckSuccess(MPI_Put(arr, arr_len, datatype_, to_rank, disp,
+                                   arr_len, datatype_, window_));
+  }
+
+  /**
+   * @brief Записывает значение в окно процесса to_rank.
+   * @param value: значение, которое нужно записать.
+   * @param to_rank: ранг получателя.
+   * @param disp: смещение (в элементах) в массиве получателя.
+   */
+  void Put(const T &value, int to_rank, MPI_Aint disp) {
+    Put(&value, 1, to_rank, disp);
+  }
+
+  /**
+   * @brief Читает массив из окна процесса from_rank.
+   * @param arr: массив, в который нужно прочитать данные.
+   * @param arr_len: количество элементов в массиве.
+   * @param from_rank: ранг процесса, из окна которого идёт чтение.
+   * @param disp: смещение (в элементах) в массиве from_rank.
+   */
+  void Get(T *arr, int arr_len, int from_rank, MPI_Aint disp) {
+    if (arr_len < 0)
+      parallel::Error("parallel::Window::Get: arr_len should be non-negative.");
+
+    parallel::CheckSuccess(MPI_Get(arr, arr_len, datatype_, from_rank, disp,
+                                   arr_len, datatype_, window_));
+  }
+
+  /**
+   * @brief Читает значение из окна процесса from_rank.
+   * @param value: значение, в которое нужно прочитать данные.
+   * @param from_rank: ранг процесса, из окна которого идёт чтение.
+   * @param disp: смещение (в элементах) в массиве from_rank.
+   */
+  void Get(T &value, int from_rank, MPI_Aint disp) {
+    Get(&value, 1, from_rank, disp);
+  }
+
+  /**
+   * @brief Атомарно применяет операцию к элементам окна процесса to_rank.
+   * @param arr: массив операндов.
+   * @param arr_len: количество элементов в массиве.
+   * @param to_rank: ранг получателя.
+   * @param disp: смещение (в элементах) в массиве получателя.
+   * @param op: операция MPI (встроенная, например MPI_SUM или MPI_REPLACE).
+   */
+  void Accumulate(const T *arr, int arr_len, int to_rank, MPI_Aint disp,
+                  MPI_Op op) {
+    if (arr_len < 0)
+      parallel::Error(
+          "parallel::Window::Accumulate: arr_len should be non-negative.");
+
+    parallel::CheckSuccess(MPI_Accumulate(arr, arr_len, datatype_, to_rank,
+                                          disp, arr_len, datatype_, op,
+                                          window_));
+  }
+
+  /**
+   * @brief Атомарно применяет операцию к элементу окна процесса to_rank.
+   * @param value: операнд.
+   * @param to_rank: ранг получателя.
+   * @param disp: смещение (в элементах) в массиве получателя.
+   * @param op: операция MPI (встроенная, например MPI_SUM или MPI_REPLACE).
+   */
+  void Accumulate(const T &value, int to_rank, MPI_Aint disp, MPI_Op op) {
+    Accumulate(&value, 1, to_rank, disp, op);
+  }
+
+  /**
+   * @brief Коллективно завершает эпоху активной синхронизации (MPI_Win_fence).
+   * @param assert: подсказки MPI (MPI_MODE_NOPRECEDE и т.п.). По умолчанию 0.
+   */
+  void Fence(int assert = 0) {
+    parallel::CheckSuccess(MPI_Win_fence(assert, window_));
+  }
+
+  /**
+   * @brief Открывает эпоху пассивной синхронизации ко всем процессам
+   * (MPI_Win_lock_all).
+   * @param assert: подсказки MPI (MPI_MODE_NOCHECK). По умолчанию 0.
+   */
+  void LockAll(int assert = 0) {
+    parallel::CheckSuccess(MPI_Win_lock_all(assert, window_));
+    is_locked_ = true;
+  }
+
+  /// @brief Закрывает эпоху пассивной синхронизации (MPI_Win_unlock_all).
+  void UnlockAll() {
+    parallel::CheckSuccess(MPI_Win_unlock_all(window_));
+    is_locked_ = false;
+  }
+
+  /**
+   * @brief Дожидается завершения всех операций, адресованных процессу rank.
+   * @param rank: ранг процесса.
+   */
+  void Flush(int rank) { parallel::CheckSuccess(MPI_Win_flush(rank, window_)); }
+
+  /// @brief Дожидается завершения всех начатых операций.
+  void FlushAll() { parallel::CheckSuccess(MPI_Win_flush_all(window_)); }
+
+ private:
+  void GatherSizes() {
+    unsigned long long size = size_;
+    std::vector<unsigned long long> sizes(parallel::RanksAmount(comm_));
+
+    parallel::CheckSuccess(MPI_Allgather(&size, 1, MPI_UNSIGNED_LONG_LONG,
+                                         sizes.data(), 1,
+                                         MPI_UNSIGNED_LONG_LONG, comm_));
+
+    sizes_.assign(sizes.begin(), sizes.end());
+  }
+
+  void Free() {
+    if (window_ == MPI_WIN_NULL) return;
+
+    int is_finalized = 0;
+    MPI_Finalized(&is_finalized);
+
+    if (!is_finalized) {
+      if (is_locked_) MPI_Win_unlock_all(window_);
+      MPI_Win_free(&window_);
+    }
+
+    window_ = MPI_WIN_NULL;
+  }
+
+  MPI_Comm comm_;
+  MPI_Datatype datatype_;
+  MPI_Win window_ = MPI_WIN_NULL;
+  T *data_ = nullptr;
+  std::size_t size_;
+  std::vector<std::size_t> sizes_;
+  bool is_locked_ = false;
+};
+
+/**
+ * @brief Записывает края массива окна прямо в фиктивные ячейки соседей по
+ * одномерной декомпозиции (односторонние MPI_Put в эпохе MPI_Win_fence).
+ * @details Массив устроен как [левая фиктивная ячейка, левый край, ...,
+ * правый край, правая фиктивная ячейка]. В отличие от MPI_Sendrecv соседям
+ * не нужно сопоставлять вызовы отправки и получения. Вызов коллективный по
+ * коммуникатору окна; у крайних процессов соответствующая фиктивная ячейка
+ * не меняется.
+ * @tparam T: тип элементов.
+ * @param window: окно над массивом (не меньше 2 элементов у каждого
+ * процесса).
+ */
+template <typename T>
+inline void ShiftHalo(Window<T> &window, bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::ShiftHalo with args: window: " << window.Data()
+              << "; ";
+
+  std::size_t size = window.Size();
+
+  if (size < 2)
+    parallel::Error("parallel::ShiftHalo: array should have ghost cells.");
+
+  int ranks_amount = parallel::RanksAmount(window.Comm());
+  int curr_rank = parallel::CurrRank(window.Comm());
+
+  window.Fence(MPI_MODE_NOPRECEDE);
+
+  // левый край - в правую фиктивную ячейку левого соседа и наоборот
+  if (curr_rank > 0)
+    window.Put(window[1], curr_rank - 1,
+               static_cast<MPI_Aint>(window.Size(curr_rank - 1) - 1));
+
+  if (curr_rank < ranks_amount - 1)
+    window.Put(window[size - 2], curr_rank + 1, 0);
+
+  window.Fence(MPI_MODE_NOSUCCEED);
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Коммуникатор декартовой решётки процессов (MPI_Cart_create).
+ * @details Решётка может быть любой размерности, периодической по любым
+ * измерениям; по умолчанию MPI разрешено переупорядочить ранги под
+ * физическую топологию (reorder), поэтому ранг процесса в решётке (Rank)
+ * может отличаться от ранга в исходном коммуникаторе. Соседи процесса
+ * упорядочены как в MPI_Cart_shift: по каждому измерению сначала нижний,
+ * затем верхний (MPI_PROC_NULL на границе непериодического измерения); в
+ * этом же порядке идут блоки NeighborAllToAll и NeighborAllToAllW. Объект
+ * можно только перемещать, но не копировать; создание и уничтожение -
+ * коллективные операции над comm.
+ */
+class CartComm {
+ public:
+  /**
+   * @param dims: количество процессов по каждому измерению (нули
+   * подбираются через MPI_Dims_create по числу процессов comm).
+   * @param periods: периодичность измерений (1 - периодическое). По
+   * умолчанию все измерения непериодические.
+   * @param reorder: разрешить MPI переупорядочить ранги. По умолчанию true.
+   * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+   */
+  explicit CartComm(std::vector<int> dims,
+                    std::vector<int> periods = std::vector<int>(),
+                    bool reorder = true, MPI_Comm comm = MPI_COMM_WORLD)
+      : dims_(std::move(dims)), periods_(std::move(periods)) {
+    int ndims = static_cast<int>(dims_.size());
+
+    if (ndims == 0)
+      parallel::Error("parallel::CartComm: dims should not be empty.");
+
+    periods_.resize(ndims, 0);
+
+    parallel::CheckSuccess(
+        MPI_Dims_create(parallel::RanksAmount(comm), ndims, dims_.data()));
+
+    parallel::CheckSuccess(MPI_Cart_create(comm, ndims, dims_.data(),
+                                           periods_.data(), reorder, &comm_));
+
+    if (comm_ == MPI_COMM_NULL)
+      parallel::Error(
+          "parallel::CartComm: grid is smaller than the communicator.");
+
+    rank_ = parallel::CurrRank(comm_);
+    coords_ = Coords(rank_);
+
+    neighbors_.resize(2 * ndims);
+    for (int dim = 0; dim < ndims; dim++)
+      Shift(dim, 1, neighbors_[2 * dim], neighbors_[2 * dim + 1]);
+  }
+
+  CartComm(const CartComm &) = delete;
+  CartComm &operator=(const CartComm &) = delete;
+
+  CartComm(CartComm &&other)
+      : comm_(other.comm_),
+        rank_(other.rank_),
+        dims_(std::move(other.dims_)),
+        periods_(std::move(other.periods_)),
+        coords_(std::move(other.coords_)),
+        neighbors_(std::move(other.neighbors_)) {
+    other.comm_ = MPI_COMM_NULL;
+  }
+
+  CartComm &operator=(CartComm &&other) {
+    if (this != &other) {
+      Free();
+
+      comm_ = other.comm_;
+      rank_ = other.rank_;
+      dims_ = std::move(other.dims_);
+      periods_ = std::move(other.periods_);
+      coords_ = std::move(other.coords_);
+      neighbors_ = std::move(other.neighbors_);
+
+      other.comm_ = MPI_COMM_NULL;
+    }
+
+    return *this;
+  }
+
+  ~CartComm() { Free(); }
+
+  MPI_Comm Handle() const { return comm_; }
+
+  /// @return ранг текущего процесса в решётке.
+  int Rank() const { return rank_; }
+
+  /// @return количество измерений решётки.
+  int NumDims() const { return static_cast<int>(dims_.size()); }
+
+  /// @return количество процессов по каждому измерению.
+  const std::vector<int> &Dims() const { return dims_; }
+
+  /// @return периодичность измерений.
+  const std::vector<int> &Periods() const { return periods_; }
+
+  /// @return координаты текущего процесса в решётке.
+  const std::vector<int> &Coords() const { return coords_; }
+
+  /**
+   * @param rank: ранг процесса в решётке.
+   * @return std::vector<int>: координаты процесса в решётке.
+   */
+  std::vector<int> Coords(int rank) const {
+    std::vector<int> coords(dims_.size());
+    parallel::CheckSuccess(
+        MPI_Cart_coords(comm_, rank, NumDims(), coords.data()));
+    return coords;
+  }
+
+  /**
+   * @param coords: координаты процесса (у периодических измерений могут
+   * выходить за границы решётки).
+   * @return int: ранг процесса в решётке.
+   */
+  int RankOf(const std::vector<int> &coords) const {
+    int rank;
+    parallel::CheckSuccess(MPI_Cart_rank(comm_, coords.data(), &rank));
+    return rank;
+  }
+
+  /**
+   * @brief Находит соседей при сдвиге вдоль измерения (MPI_Cart_shift).
+   * @param dim: измерение.
+   * @param disp: величина сдвига.
+   * @param from_rank: от кого приходят данные при сдвиге (или
+   * MPI_PROC_NULL) (мод.).
+   * @param to_rank: кому уходят данные при сдвиге (или MPI_PROC_NULL)
+   * (мод.).
+   */
+  void Shift(int dim, int disp, int &from_rank, int &to_rank) const {
+    parallel::CheckSuccess(
+        MPI_Cart_shift(comm_, dim, disp, &from_rank, &to_rank));
+  }
+
+  /// @return соседи в порядке блоков соседских коллективных операций.
+  const std::vector<int> &Neighbors() const { return neighbors_; }
+
+  /**
+   * @brief Обменивается блоками одинаковой длины со всеми соседями одной
+   * операцией (MPI_Neighbor_alltoall).
+   * @tparam T: тип элементов.
+   * @param from_arr: 2 * NumDims() блоков по arr_len элементов, i-й блок
+   * уходит соседу Neighbors()[i].
+   * @param arr_len: количество элементов в одном блоке.
+   * @param to_arr: 2 * NumDims() блоков по arr_len элементов, i-й блок
+   * приходит от соседа Neighbors()[i].
+   * @param datatype: тип данных элементов.
+   */
+  template <typename T>
+  void NeighborAllToAll(const T *from_arr, int arr_len, T *to_arr,
+                        MPI_Datatype datatype) const {
+    if (arr_len < 0)
+      parallel::Error(
+          "parallel::CartComm::NeighborAllToAll: arr_len should be "
+          "non-negative.");
+
+    parallel::CheckSuccess(MPI_Neighbor_alltoall(
+        from_arr, arr_len, datatype, to_arr, arr_len, datatype, comm_));
+  }
+
+  /**
+   * @brief Обменивается с соседями блоками разных производных типов одной
+   * операцией (MPI_Neighbor_alltoallw), без упаковки в буфер.
+   * @details Все массивы описаний содержат по 2 * NumDims() элементов в
+   * порядке Neighbors(); смещения задаются в байтах.
+   * @param from_buffer: начало отправляемых данных.
+   * @param from_counts: количество элементов типа from_datatypes[i] для i-го
+   * соседа.
+   * @param from_displacements: смещения блоков от from_buffer.
+   * @param from_datatypes: типы данных блоков.
+   * @param to_buffer: начало получаемых данных.
+   * @param to_counts: количество элементов, получаемых от i-го соседа.
+   * @param to_displacements: смещения блоков от to_buffer.
+   * @param to_datatypes: типы данных блоков.
+   */
+  void NeighborAllToAllW(const void *from_buffer, const int *from_counts,
+                         const MPI_Aint *from_displacements,
+                         const MPI_Datatype *from_datatypes, void *to_buffer,
+                         const int *to_counts,
+                         const MPI_Aint *to_displacements,
+                         const MPI_Datatype *to_datatypes) const {
+    parallel::CheckSuccess(MPI_Neighbor_alltoallw(
+        from_buffer, from_counts, from_displacements, from_datatypes,
+        to_buffer, to_counts, to_displacements, to_datatypes, comm_));
+  }
+
+ private:
+  void Free() {
+    if (comm_ == MPI_COMM_NULL) return;
+
+    int is_finalized = 0;
+    MPI_Finalized(&is_finalized);
+
+    if (!is_finalized) MPI_Comm_free(&comm_);
+
+    comm_ = MPI_COMM_NULL;
+  }
+
+  MPI_Comm comm_ = MPI_COMM_NULL;
+  int rank_ = MPI_PROC_NULL;
+  std::vector<int> dims_;
+  std::vector<int> periods_;
+  std::vector<int> coords_;
+  std::vector<int> neighbors_;
+};
+
+/**
+ * @brief Обменивается теневыми гранями локального блока сетки со всеми
+ * соседями по решётке одной операцией MPI_Neighbor_alltoallw.
+ * @details Блок хранится по строкам (порядок C) и окружён по каждому
+ * измерению слоем фиктивных ячеек толщины 1: sizes[d] включает оба слоя.
+ * Соседу отправляется крайний внутренний слой, в фиктивный слой записывается
+ * крайний слой соседа; угловые ячейки не передаются (достаточно для
+ * шаблонов «крест»). Типы граней кэшируются (parallel::CachedDatatype). На
+ * границах непериодических измерений фиктивные слои не меняются.
+ * @tparam T: тип элементов.
+ * @param cart: решётка процессов (cart.NumDims() == sizes.size()).
+ * @param arr: локальный блок вместе с фиктивными ячейками.
+ * @param sizes: размеры блока по измерениям вместе с фиктивными ячейками
+ * (не меньше 3).
+ * @param datatype: тип данных элементов.
+ */
+template <typename T>
+inline void ShiftHalo(const CartComm &cart, T *arr,
+                      const std::vector<int> &sizes, MPI_Datatype datatype,
+                      bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::ShiftHalo with args: cart: " << cart.Handle()
+              << "; arr: " << arr << "; sizes: " << sizes
+              << "; datatype: " << datatype << "; ";
+
+  int ndims = cart.NumDims();
+
+  if (static_cast<int>(sizes.size()) != ndims)
+    parallel::Error("parallel::ShiftHalo: sizes should match cart dims.");
+
+  for (int dim = 0; dim < ndims; dim++)
+    if (sizes[dim] < 3)
+      parallel::Error("parallel::ShiftHalo: block should have ghost cells.");
+
+  PooledBuffer<int> counts(2 * ndims);
+  PooledBuffer<MPI_Aint> displacements(2 * ndims);
+  PooledBuffer<MPI_Datatype> send_datatypes(2 * ndims);
+  PooledBuffer<MPI_Datatype> recv_datatypes(2 * ndims);
+
+  // форма грани: {1, ndims, sizes..., subsizes..., starts...}
+  std::vector<int> shape(2 + 3 * ndims);
+  shape[0] = 1;
+  shape[1] = ndims;
+
+  for (int dim = 0; dim < ndims; dim++) {
+    for (int i = 0; i < ndims; i++) {
+      shape[2 + i] = sizes[i];
+      shape[2 + ndims + i] = i == dim ? 1 : sizes[i] - 2;
+      shape[2 + 2 * ndims + i] = 1;
+    }
+
+    int *start = &shape[2 + 2 * ndims + dim];
+
+    // нижний сосед: свой первый внутренний слой, его слой - в слой 0
+    *start = 1;
+    send_datatypes[2 * dim] = parallel::CachedDatatype(datatype, shape);
+    *start = 0;
+    recv_datatypes[2 * dim] = parallel::CachedDatatype(datatype, shape);
+
+    // верхний сосед: свой последний внутренний слой, его слой - в последний
+    *start = sizes[dim] - 2;
+    send_datatypes[2 * dim + 1] = parallel::CachedDatatype(datatype, shape);
+    *start = sizes[dim] - 1;
+    recv_datatypes[2 * dim + 1] = parallel::CachedDatatype(datatype, shape);
+
+    counts[2 * dim] = counts[2 * dim + 1] = 1;
+    displacements[2 * dim] = displacements[2 * dim + 1] = 0;
+  }
+
+  cart.NeighborAllToAllW(arr, counts.Data(), displacements.Data(),
+                         send_datatypes.Data(), arr, counts.Data(),
+                         displacements.Data(), recv_datatypes.Data());
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Обменивается теневыми гранями локального блока сетки со всеми
+ * соседями по решётке (тип данных выводится из T).
+ * @tparam T: тип элементов.
+ * @param cart: решётка процессов.
+ * @param arr: локальный блок вместе с фиктивными ячейками.
+ * @param sizes: размеры блока по измерениям вместе с фиктивными ячейками.
+ */
+template <typename T>
+inline void ShiftHalo(const CartComm &cart, T *arr,
+                      const std::vector<int> &sizes, bool need_print = false) {
+  parallel::ShiftHalo(cart, arr, sizes, mpi_type<T>::get(), need_print);
+}
+
+/**
+ * @brief Накопитель мелких сообщений: объединяет отправки одному и тому же
+ * получателю в один пакет.
+ * @details Значения, отправленные методом Send, копируются в буфер
+ * получателя. Буфер отправляется одним сообщением (MPI_Isend из байтов),
+ * когда его размер достигает порога, при явном вызове Flush или при вызове
+ * Barrier. Получатель читает значения методом Receive в том же порядке и
+ * тех же типов, в каком они были отправлены: пакеты разбираются
+ * автоматически, и значение или массив может продолжаться в следующем
+ * пакете. Передавать можно только тривиально копируемые типы.
+ *
+ * Пакеты передаются по собственной копии коммуникатора (MPI_Comm_dup),
+ * поэтому не пересекаются с другими сообщениями на нём. Создание Batcher -
+ * коллективная операция: все процессы коммуникатора создают свои Batcher
+ * в одном и том же порядке.
+ */
+class Batcher {
+ public:
+  /**
+   * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+   * @param flush_size: размер буфера получателя (в байтах), при котором он
+   * отправляется автоматически. По умолчанию 4096.
+   * @param tag: тег пакетов в копии коммуникатора. По умолчанию
+   * PARALLEL_SERVICE_TAG.
+   */
+  explicit Batcher(MPI_Comm comm = MPI_COMM_WORLD,
+                   std::size_t flush_size = 4096,
+                   int tag = PARALLEL_SERVICE_TAG)
+      : flush_size_(flush_size),
+        tag_(tag),
+        send_buffers_(parallel::RanksAmount(comm)),
+        recv_buffers_(parallel::RanksAmount(comm)),
+        recv_offsets_(parallel::RanksAmount(comm), 0) {
+    parallel::CheckSuccess(MPI_Comm_dup(comm, &comm_));
+  }
+
+  Batcher(const Batcher &) = delete;
+  Batcher &operator=(const Batcher &) = delete;
+
+  ~Batcher() {
+    int is_finalized = 0;
+    MPI_Finalized(&is_finalized);
+
+    if (is_finalized) return;
+
+    Flush();
+
+    // отправки завершаются до освобождения коммуникатора
+    in_flight_requests_.clear();
+    MPI_Comm_free(&comm_);
+  }
+
+  /**
+   * @brief Добавляет массив в буфер получателя.
+   * @tparam T: тип элементов массива.
+   * @param arr: массив, который нужно отправить.
+   * @param arr_len: количество элементов в массиве.
+   * @param to_rank: ранг получателя.
+   */
+  template <typename T>
+  void Send(const T *arr, int arr_len, int to_rank) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "parallel::Batcher: T should be trivially copyable.");
+
+    if (arr_len < 0)
+      parallel::Error(
+          "parallel::Batcher::Send: arr_len should be non-negative.");
+
+    std::vector<char> &buffer = send_buffers_[to_rank];
+
+    const char *bytes = reinterpret_cast<const char *>(arr);
+    buffer.insert(buffer.end(), bytes, bytes + arr_len * sizeof(T));
+
+    if (buffer.size() >= flush_size_) Flush(to_rank);
+  }
+
+  /**
+   * @brief Добавляет значение в буфер получателя.
+   * @tparam T: тип значения.
+   * @param value: отправляемое значение.
+   * @param to_rank: ранг получателя.
+   */
+  template <typename T>
+  void Send(const T &value, int to_rank) {
+    Send(&value, 1, to_rank);
+  }
+
+  /**
+   * @brief Получает массив, отправленный через Batcher::Send.
+   * @tparam T: тип элементов массива.
+   * @param arr: массив, в который нужно получить данные.
+   * @param arr_len: количество элементов в массиве.
+   * @param from_rank: ранг отправителя. По умолчанию MPI_ANY_SOURCE.
+   * @return int: ранг отправителя.
+   */
+  template <typename T>
+  int Receive(T *arr, int arr_len, int from_rank = MPI_ANY_SOURCE) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "parallel::Batcher: T should be trivially copyable.");
+
+    if (arr_len < 0)
+      parallel::Error(
+          "parallel::Batcher::Receive: arr_len should be non-negative.");
+
+    from_rank = NextSource(from_rank);
+
+    char *bytes = static_cast<char *>(static_cast<void *>(arr));
+    std::size_t size = arr_len * sizeof(T), copied = 0;
+
+    for (;;) {
+      std::vector<char> &buffer = recv_buffers_[from_rank];
+      std::size_t &offset = recv_offsets_[from_rank];
+      std::size_t part = Min(size - copied, buffer.size() - offset);
+
+      std::memcpy(bytes + copied, buffer.data() + offset, part);
+      copied += part;
+      offset += part;
+
+      if (copied == size) break;
+
+      // данные продолжаются в следующем пакете того же отправителя
+      from_rank = NextSource(from_rank);
+    }
+
+    return from_rank;
+  }
+
+  /**
+   * @brief Получает значение, отправленное через Batcher::Send.
+   * @tparam T: тип значения.
+   * @param value: получаемое значение.
+   * @param from_rank: ранг отправителя. По умолчанию MPI_ANY_SOURCE.
+   * @return int: ранг отправителя.
+   */
+  template <typename T>
+  int Receive(T &value, int from_rank = MPI_ANY_SOURCE) {
+    return Receive(&value, 1, from_rank);
+  }
+
+  /**
+   * @brief Отправляет накопленный буфер получателя.
+   * @param to_rank: ранг получателя.
+   */
+  void Flush(int to_rank) {
+    std::vector<char> &buffer = send_buffers_[to_rank];
+
+    if (buffer.empty()) return;
+
+    ReleaseCompleted();
+
+    // буфер должен жить до завершения отправки, поэтому пакет копируется в
+    // блок из пула, а буфер получателя очищается с сохранением ёмкости
+    in_flight_buffers_.push_back(PooledBuffer<char>(buffer.size()));
+
+    PooledBuffer<char> &batch = in_flight_buffers_.back();
+    std::memcpy(batch.Data(), buffer.data(), buffer.size());
+    buffer.clear();
+
+    in_flight_requests_.push_back(parallel::ISend(
+        batch.Data(), static_cast<int>(batch.Size()), MPI_BYTE, to_rank, tag_,
+        comm_));
+  }
+
+  /// @brief Отправляет накопленные буферы всех получателей.
+  void Flush() {
+    for (std::size_t i = 0; i < send_buffers_.size(); i++)
+      Flush(static_cast<int>(i));
+  }
+
+  /**
+   * @brief Отправляет все буферы, дожидается завершения отправок и
+   * синхронизирует процессы коммуникатора.
+   * @details Пока отправки и синхронизация (MPI_Ibarrier) не завершены,
+   * пришедшие пакеты принимаются в буферы отправителей, поэтому схема
+   * "Send, Barrier, Receive" работает при любом размере пакетов.
+   */
+  void Barrier() {
+    Flush();
+
+    Request barrier;
+    bool is_barrier_started = false;
+
+    for (;;) {
+      ReceivePending();
+      ReleaseCompleted();
+
+      // синхронизация начинается только после завершения своих отправок
+      if (!is_barrier_started && in_flight_requests_.empty()) {
+        parallel::CheckSuccess(MPI_Ibarrier(comm_, &barrier.Handle()));
+        is_barrier_started = true;
+      }
+
+      if (is_barrier_started && barrier.Test()) break;
+    }
+  }
+
+ private:
+  /**
+   * @brief Находит отправителя, от которого есть непрочитанные данные, и при
+   * необходимости принимает от него следующий пакет.
+   * @param from_rank: ранг отправителя (или MPI_ANY_SOURCE).
+   * @return int: ранг отправителя.
+   */
+  int NextSource(int from_rank) {
+    if (from_rank == MPI_ANY_SOURCE)
+      for (std::size_t i = 0; i < recv_buffers_.size(); i++)
+        if (recv_offsets_[i] < recv_buffers_[i].size())
+          return static_cast<int>(i);
+
+    if (from_rank != MPI_ANY_SOURCE &&
+        recv_offsets_[from_rank] < recv_buffers_[from_rank].size())
+      return from_rank;
+
+    // данных нет: ждём следующий пакет (от любого отправителя, если нужно)
+    MPI_Message message;
+    MPI_Status status;
+    parallel::CheckSuccess(
+        MPI_Mprobe(from_rank, tag_, comm_, &message, &status));
+
+    return ReceivePacket(message, status);
+  }
+
+  /**
+   * @brief Принимает найденный пакет и дописывает его в буфер отправителя.
+   * @details Прочитанное начало буфера отбрасывается, непрочитанные данные
+   * предыдущих пакетов сохраняются.
+   * @param message: найденное сообщение (MPI_Mprobe или MPI_Improbe).
+   * @param status: статус сообщения.
+   * @return int: ранг отправителя.
+   */
+  int ReceivePacket(MPI_Message &message, const MPI_Status &status) {
+    int from_rank = status.MPI_SOURCE;
+
+    int size = 0;
+    parallel::CheckSuccess(MPI_Get_count(&status, MPI_BYTE, &size));
+
+    std::vector<char> &buffer = recv_buffers_[from_rank];
+    std::size_t &offset = recv_offsets_[from_rank];
+
+    buffer.erase(buffer.begin(), buffer.begin() + offset);
+    offset = 0;
+
+    std::size_t old_size = buffer.size();
+    buffer.resize(old_size + size);
+
+    parallel::CheckSuccess(MPI_Mrecv(buffer.data() + old_size, size, MPI_BYTE,
+                                     &message, MPI_STATUS_IGNORE));
+
+    return from_rank;
+  }
+
+  /// @brief Принимает все уже пришедшие пакеты, не дожидаясь новых.
+  void ReceivePending() {
+    for (;;) {
+      int has_message = 0;
+      MPI_Message message;
+      MPI_Status status;
+
+      parallel::CheckSuccess(MPI_Improbe(MPI_ANY_SOURCE, tag_, comm_,
+                                         &has_message, &message, &status));
+
+      if (!has_message) return;
+
+      ReceivePacket(message, status);
+    }
+  }
+
+  /// @brief Освобождает буферы уже завершённых отправок.
+  void ReleaseCompleted() {
+    std::size_t curr = 0;
+
+    for (std::size_t i = 0; i < in_flight_requests_.size(); i++) {
+      if (in_flight_requests_[i].Test()) continue;
+
+      if (curr != i) {
+        in_flight_requests_[curr] = std::move(in_flight_requests_[i]);
+        in_flight_buffers_[curr] = std::move(in_flight_buffers_[i]);
+      }
+
+      curr++;
+    }
+
+    in_flight_requests_.resize(curr);
+    in_flight_buffers_.erase(in_flight_buffers_.begin() + curr,
+                             in_flight_buffers_.end());
+  }
+
+  MPI_Comm comm_ = MPI_COMM_NULL;
+  std::size_t flush_size_;
+  int tag_;
+
+  std::vector<std::vector<char>> send_buffers_;
+  std::vector<std::vector<char>> recv_buffers_;
+  std::vector<std::size_t> recv_offsets_;
+
+  // буферы объявлены раньше операций, чтобы уничтожаться после их завершения
+  std::vector<PooledBuffer<char>> in_flight_buffers_;
+  std::vector<Request> in_flight_requests_;
+};
+
+/**
+ * @brief Рассылает значение от процесса с указанным рангом по сети MPI.
+ * @tparam T: тип рассылаемого значения.
+ * @param value: рассылаемое значение.
+ * @param datatype: тип данных значения.
+ * @param from_rank: ранг процесса рассылки. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void Broadcast(T &value, MPI_Datatype datatype, int from_rank = 0,
+                      MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::Broadcast with args: value: " << value
+              << "; datatype: " << datatype << "; from_rank: " << from_rank
+              << "; comm: " << comm;
+
+  parallel::CheckSuccess(MPI_Bcast(&value, 1, datatype, from_rank, comm));
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Рассылает массив от процесса с указанным рангом по сети MPI.
+ * @tparam T: тип элементов рассылаемого массива.
+ * @param arr: рассылаемый массив.
+ * @param arr_len: количество элементов в массиве.
+ * @param datatype: тип данных элементов массива.
+ * @param from_rank: ранг процесса рассылки. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void Broadcast(T *arr, int arr_len, MPI_Datatype datatype,
+                      int from_rank = 0, MPI_Comm comm = MPI_COMM_WORLD,
+                      bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::Broadcast with args: arr: " << arr
+              << "; arr_len: " << arr_len << "; datatype: " << datatype
+              << "; from_rank: " << from_rank << "; comm: " << comm;
+
+  if (arr_len <= 0)
+    parallel::Error("parallel::Broadcast: arr_len should be non-negative.");
+
+  parallel::CheckSuccess(MPI_Bcast(arr, arr_len, datatype, from_rank, comm));
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Рассылает вектор от процесса с указанным рангом по сети MPI.
+ * @tparam T: тип элементов рассылаемого вектора.
+ * @param vec: рассылаемый вектор.
+ * @param datatype: тип данных элементов вектора.
+ * @param from_rank: ранг процесса рассылки. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void Broadcast(std::vector<T> &vec, MPI_Datatype datatype,
+                      int from_rank = 0, MPI_Comm comm = MPI_COMM_WORLD,
+                      bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::Broadcast with args: vec: " << vec
+              << "; datatype: " << datatype << "; from_rank: " << from_rank
+              << "; comm: " << comm;
+
+  if (vec.size() > PARALLEL_MAX_COUNT)
+    parallel::BroadcastLarge(vec.data(), vec.size(), datatype, from_rank, comm);
+  else
+    parallel::Broadcast(vec.data(), static_cast<int>(vec.size()), datatype,
+                        from_rank, comm);
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Рассылает значение от процесса с указанным рангом по сети MPI (тип
+ * данных выводится из T).
+ * @tparam T: тип рассылаемого значения.
+ * @param value: рассылаемое значение.
+ * @param from_rank: ранг процесса рассылки. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T,
+          typename = typename std::enable_if<is_mpi_type<T>::value>::type>
+inline void Broadcast(T &value, int from_rank = 0,
+                      MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
+  parallel::Broadcast(&value, 1, mpi_type<T>::get(), from_rank, comm,
+                      need_print);
+}
+
+/**
+ * @brief Рассылает массив от процесса с указанным рангом по сети MPI (тип
+ * данных выводится из T).
+ * @tparam T: тип элементов рассылаемого массива.
+ * @param arr: рассылаемый массив.
+ * @param arr_len: количество элементов в массиве.
+ * @param from_rank: ранг процесса рассылки. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void Broadcast(T *arr, int arr_len, int from_rank = 0,
+                      MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
+  parallel::Broadcast(arr, arr_len, mpi_type<T>::get(), from_rank, comm,
+                      need_print);
+}
+
+/**
+ * @brief Рассылает вектор от процесса с указанным рангом по сети MPI (тип
+ * данных выводится из T).
+ * @tparam T: тип элементов рассылаемого вектора.
+ * @param vec: рассылаемый вектор (на всех процессах должен иметь одинаковый
+ * размер).
+ * @param from_rank: ранг процесса рассылки. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void Broadcast(std::vector<T> &vec, int from_rank = 0,
+                      MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
+  if (vec.size() > PARALLEL_MAX_COUNT)
+    parallel::BroadcastLarge(vec.data(), vec.size(), mpi_type<T>::get(),
+                             from_rank, comm);
+  else
+    parallel::Broadcast(vec.data(), static_cast<int>(vec.size()),
+                        mpi_type<T>::get(), from_rank, comm, need_print);
+}
+
+/**
+ * @brief Алгоритм рассылки для parallel::TunedBroadcast.
+ */
+enum class BroadcastAlgorithm {
+  /// @brief выбор по размеру сообщения и числу процессов (BroadcastTuning)
+  Auto,
+  /// @brief реализация библиотеки MPI (MPI_Bcast)
+  Library,
+  /// @brief биномиальное дерево: log2(p) шагов, целое сообщение на шаге
+  Binomial,
+  /// @brief биномиальная раздача частей и их кольцевой сбор (van de Geijn)
+  ScatterAllGather,
+  /// @brief конвейер по цепочке процессов частями по segment_bytes
+  Chain
+};
+
+/**
+ * @brief Пороги выбора алгоритма рассылки в режиме BroadcastAlgorithm::Auto.
+ * @details Значения по умолчанию подходят для типичной сети; под конкретный
+ * кластер их подбирает parallel::CalibrateBroadcast. Пороги должны быть
+ * одинаковыми на всех процессах коммуникатора.
+ */
+struct BroadcastTuning {
+  /// @brief до этого размера сообщения (байт) - биномиальное дерево
+  std::size_t binomial_max_bytes = 12 * 1024;
+  /// @brief с этого размера сообщения (байт) - конвейер по цепочке
+  std::size_t chain_min_bytes = 1024 * 1024;
+  /// @brief при меньшем числе процессов - всегда биномиальное дерево
+  int min_ranks = 4;
+  /// @brief размер части конвейера (байт)
+  std::size_t segment_bytes = 64 * 1024;
+
+  /// @return пороги, которыми пользуется TunedBroadcast по умолчанию.
+  static BroadcastTuning &Global() {
+    static BroadcastTuning tuning;
+    return tuning;
+  }
+};
+
+/**
+ * @brief Рассылка биномиальным деревом на обменах точка-точка.
+ * @param buffer: рассылаемые данные.
+ * @param arr_len: количество элементов.
+ * @param datatype: тип данных элементов.
+ * @param from_rank: ранг процесса рассылки.
+ * @param comm: коммуникатор MPI.
+ */
+inline void BinomialBroadcast(void *buffer, int arr_len, MPI_Datatype datatype,
+                              int from_rank, MPI_Comm comm) {
+  int ranks_amount = parallel::RanksAmount(comm);
+  int relative_rank =
+      (parallel::CurrRank(comm) - from_rank + ranks_amount) % ranks_amount;
+
+  int mask = 1;
+
+  for (; mask < ranks_amount; mask <<= 1)
+    if (relative_rank & mask) {
+      int parent = (relative_rank - mask + from_rank) % ranks_amount;
+      parallel::CheckSuccess(MPI_Recv(buffer, arr_len, datatype, parent,
+                                      PARALLEL_COLLECTIVE_TAG, comm,
+                                      MPI_STATUS_IGNORE));
+      break;
+    }
+
+  for (mask >>= 1; mask > 0; mask >>= 1)
+    if (relative_rank + mask < ranks_amount) {
+      int child = (relative_rank + mask + from_rank) % ranks_amount;
+      parallel::CheckSuccess(MPI_Send(buffer, arr_len, datatype, child,
+                                      PARALLEL_COLLECTIVE_TAG, comm));
+    }
+}
+
+/**
+ * @brief Рассылка раздачей частей биномиальным деревом и их сбором по
+ * кольцу: каждый процесс передаёт около 2 * (p - 1) / p сообщения, поэтому
+ * подходит для средних сообщений на большом числе процессов.
+ * @param buffer: рассылаемые данные.
+ * @param arr_len: количество элементов.
+ * @param datatype: тип данных элементов.
+ * @param from_rank: ранг процесса рассылки.
+ * @param comm: коммуникатор MPI.
+ */
+inline void ScatterAllGatherBroadcast(void *buffer, int arr_len,
+                                      MPI_Datatype datatype, int from_rank,
+                                      MPI_Comm comm) {
+  int ranks_amount = parallel::RanksAmount(comm);
+  int relative_rank =
+      (parallel::CurrRank(comm) - from_rank + ranks_amount) % ranks_amount;
+
+  MPI_Aint lower_bound, extent;
+  parallel::CheckSuccess(MPI_Type_get_extent(datatype, &lower_bound, &extent));
+
+  char *bytes = static_cast<char *>(buffer);
+  int block_len = (arr_len + ranks_amount - 1) / ranks_amount;
+
+  // части процессов [first, last) относительно from_rank
+  auto blocks_len = [&](int first, int last) {
+    long long begin = static_cast<long long>(first) * block_len;
+    long long end = static_cast<long long>(Min(last, ranks_amount)) * block_len;
+    end = Min(end, static_cast<long long>(arr_len));
+    return static_cast<int>(std::max(0LL, end - begin));
+  };
+  auto block = [&](int index) {
+    return bytes + static_cast<MPI_Aint>(index) * block_len * extent;
+  };
+
+  int mask = 1;
+
+  for (; mask < ranks_amount; mask <<= 1)
+    if (relative_rank & mask) {
+      int parent = (relative_rank - mask + from_rank) % ranks_amount;
+      int len = blocks_len(relative_rank, relative_rank + mask);
+
+      if (len > 0)
+        parallel::CheckSuccess(MPI_Recv(block(relative_rank), len, datatype,
+                                        parent, PARALLEL_COLLECTIVE_TAG, comm,
+                                        MPI_STATUS_IGNORE));
+      break;
+    }
+
+  for (mask >>= 1; mask > 0; mask >>= 1)
+    if (relative_rank + mask < ranks_amount) {
+      int child = relative_rank + mask;
+      int len = blocks_len(child, child + mask);
+
+      if (len > 0)
+        parallel::CheckSuccess(MPI_Send(block(child), len, datatype,
+                                        (child + from_rank) % ranks_amount,
+                                        PARALLEL_COLLECTIVE_TAG, comm));
+    }
+
+  int left = (relative_rank - 1 + ranks_amount) % ranks_amount;
+  int right = (relative_rank + 1) % ranks_amount;
+
+  for (int step = 0; step < ranks_amount - 1; step++) {
+    int send_index = (relative_rank - step + ranks_amount) % ranks_amount;
+    int recv_index = (relative_rank - step - 1 + ranks_amount) % ranks_amount;
+
+    parallel::CheckSuccess(MPI_Sendrecv(
+        block(send_index), blocks_len(send_index, send_index + 1), datatype,
+        (right + from_rank) % ranks_amount, PARALLEL_COLLECTIVE_TAG,
+        block(recv_index), blocks_len(recv_index, recv_index + 1), datatype,
+        (left + from_rank) % ranks_amount, PARALLEL_COLLECTIVE_TAG, comm,
+        MPI_STATUS_IGNORE));
+  }
+}
+
+/**
+ * @brief Рассылка конвейером по цепочке процессов: сообщение идёт частями,
+ * и каждая часть пересылается дальше, пока принимается следующая, поэтому
+ * время рассылки больших сообщений близко к времени одной передачи.
+ * @param buffer: рассылаемые данные.
+ * @param arr_len: количество элементов.
+ * @param datatype: тип данных элементов.
+ * @param from_rank: ранг процесса рассылки.
+ * @param segment_bytes: размер части (байт).
+ * @param comm: коммуникатор MPI.
+ */
+inline void ChainBroadcast(void *buffer, int arr_len, MPI_Datatype datatype,
+                           int from_rank, std::size_t segment_bytes,
+                           MPI_Comm comm) {
+  int ranks_amount = parallel::RanksAmount(comm);
+  int relative_rank =
+      (parallel::CurrRank(comm) - from_rank + ranks_amount) % ranks_amount;
+
+  MPI_Aint lower_bound, extent;
+  parallel::CheckSuccess(MPI_Type_get_extent(datatype, &lower_bound, &extent));
+
+  char *bytes = static_cast<char *>(buffer);
+  std::size_t segment_elems =
+      std::max(segment_bytes / static_cast<std::size_t>(extent),
+               static_cast<std::size_t>(1));
+  int segment_len = static_cast<int>(
+      Min(segment_elems, static_cast<std::size_t>(std::max(arr_len, 1))));
+  int segments_amount = (arr_len + segment_len - 1) / segment_len;
+
+  int prev = (relative_rank - 1 + from_rank) % ranks_amount;
+  int next = (relative_rank + 1 + from_rank) % ranks_amount;
+  bool has_next = relative_rank + 1 < ranks_amount;
+
+  PooledBuffer<MPI_Request> requests(has_next ? segments_amount : 0);
+
+  for (int i = 0; i < segments_amount; i++) {
+    char *segment = bytes + static_cast<MPI_Aint>(i) * segment_len * extent;
+    int len = Min(segment_len, arr_len - i * segment_len);
+
+    if (relative_rank > 0)
+      parallel::CheckSuccess(MPI_Recv(segment, len, datatype, prev,
+                                      PARALLEL_COLLECTIVE_TAG, comm,
+                                      MPI_STATUS_IGNORE));
+
+    if (has_next)
+      parallel::CheckSuccess(MPI_Isend(segment, len, datatype, next,
+                                       PARALLEL_COLLECTIVE_TAG, comm,
+                                       &requests[i]));
+  }
+
+  if (has_next)
+    parallel::CheckSuccess(MPI_Waitall(segments_amount, requests.Data(),
+                                       MPI_STATUSES_IGNORE));
+}
+
+/**
+ * @brief Рассылает массив от процесса с указанным рангом выбранным
+ * алгоритмом (см. parallel::BroadcastAlgorithm).
+ * @details В режиме Auto алгоритм выбирается по размеру сообщения и числу
+ * процессов с порогами BroadcastTuning::Global(); выбор одинаков на всех
+ * процессах. Алгоритмы построены на обменах точка-точка с тегом
+ * PARALLEL_COLLECTIVE_TAG.
+ * @tparam T: тип элементов рассылаемого массива.
+ * @param arr: рассылаемый массив (на остальных процессах - куда записать).
+ * @param arr_len: количество элементов в массиве.
+ * @param datatype: тип данных элементов массива.
+ * @param from_rank: ранг процесса рассылки. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ * @param algorithm: алгоритм рассылки. По умолчанию Auto.
+ */
+template <typename T>
+inline void TunedBroadcast(
+    T *arr, int arr_len, MPI_Datatype datatype, int from_rank = 0,
+    MPI_Comm comm = MPI_COMM_WORLD,
+    BroadcastAlgorithm algorithm = BroadcastAlgorithm::Auto,
+    bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::TunedBroadcast with args: arr: " << arr
+              << "; arr_len: " << arr_len << "; datatype: " << datatype
+              << "; from_rank: " << from_rank << "; comm: " << comm
+              << "; algorithm: " << static_cast<int>(algorithm);
+
+  if (arr_len < 0)
+    parallel::Error(
+        "parallel::TunedBroadcast: arr_len should be non-negative.");
+
+  const BroadcastTuning &tuning = BroadcastTuning::Global();
+
+  if (algorithm == BroadcastAlgorithm::Auto) {
+    int type_size;
+    parallel::CheckSuccess(MPI_Type_size(datatype, &type_size));
+
+    std::size_t bytes = static_cast<std::size_t>(arr_len) * type_size;
+
+    if (parallel::RanksAmount(comm) < tuning.min_ranks ||
+        bytes <= tuning.binomial_max_bytes)
+      algorithm = BroadcastAlgorithm::Binomial;
+    else if (bytes >= tuning.chain_min_bytes)
+      algorithm = BroadcastAlgorithm::Chain;
+    else
+      algorithm = BroadcastAlgorithm::ScatterAllGather;
+  }
+
+  switch (algorithm) {
+    case BroadcastAlgorithm::Binomial:
+      parallel::BinomialBroadcast(arr, arr_len, datatype, from_rank, comm);
+      break;
+    case BroadcastAlgorithm::ScatterAllGather:
+      parallel::ScatterAllGatherBroadcast(arr, arr_len, datatype, from_rank,
+                                          comm);
+      break;
+    case BroadcastAlgorithm::Chain:
+      parallel::ChainBroadcast(arr, arr_len, datatype, from_rank,
+                               tuning.segment_bytes, comm);
+      break;
+    default:
+      parallel::CheckSuccess(
+          MPI_Bcast(arr, arr_len, datatype, from_rank, comm));
+  }
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Рассылает массив от процесса с указанным рангом выбранным
+ * алгоритмом (тип данных выводится из T).
+ * @tparam T: тип элементов рассылаемого массива.
+ * @param arr: рассылаемый массив.
+ * @param arr_len: количество элементов в массиве.
+ * @param from_rank: ранг процесса рассылки. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ * @param algorithm: алгоритм рассылки. По умолчанию Auto.
+ */
+template <typename T>
+inline void TunedBroadcast(
+    T *arr, int arr_len, int from_rank = 0, MPI_Comm comm = MPI_COMM_WORLD,
+    BroadcastAlgorithm algorithm = BroadcastAlgorithm::Auto,
+    bool need_print = false) {
+  parallel::TunedBroadcast(arr, arr_len, mpi_type<T>::get(), from_rank, comm,
+                           algorithm, need_print);
+}
+
+/**
+ * @brief Рассылает вектор от процесса с указанным рангом выбранным
+ * алгоритмом (тип данных выводится из T).
+ * @tparam T: тип элементов рассылаемого вектора.
+ * @param vec: рассылаемый вектор (на всех процессах должен иметь одинаковый
+ * размер).
+ * @param from_rank: ранг процесса рассылки. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ * @param algorithm: алгоритм рассылки. По умолчанию Auto.
+ */
+template <typename T>
+inline void TunedBroadcast(
+    std::vector<T> &vec, int from_rank = 0, MPI_Comm comm = MPI_COMM_WORLD,
+    BroadcastAlgorithm algorithm = BroadcastAlgorithm::Auto,
+    bool need_print = false) {
+  if (vec.size() > INT_MAX)
+    parallel::Error(
+        "parallel::TunedBroadcast: vector is too big (size > INT_MAX).");
+
+  parallel::TunedBroadcast(vec.data(), static_cast<int>(vec.size()),
+                           mpi_type<T>::get(), from_rank, comm, algorithm,
+                           need_print);
+}
+
+/**
+ * @brief Подбирает пороги BroadcastTuning::Global() микробенчмарком на comm
+ * (коллективно).
+ * @details Для размеров от 1 КиБ до max_bytes (с шагом x4) замеряются
+ * Binomial, ScatterAllGather и Chain (время - максимум по процессам, поэтому
+ * решения одинаковы везде). Размер части конвейера выбирается из 16, 64 и
+ * 256 КиБ на самом большом сообщении. binomial_max_bytes - наибольший
+ * размер, на котором дерево быстрее остальных, chain_min_bytes - первый
+ * больший размер, на котором конвейер быстрее раздачи со сбором.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ * @param max_bytes: наибольший замеряемый размер сообщения (байт). По
+ * умолчанию 8 МиБ.
+ * @return BroadcastTuning: подобранные пороги.
+ */
+inline BroadcastTuning CalibrateBroadcast(MPI_Comm comm = MPI_COMM_WORLD,
+                                          std::size_t max_bytes = 1 << 23,
+                                          bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::CalibrateBroadcast with args: comm: " << comm
+              << "; max_bytes: " << max_bytes << "; ";
+
+  BroadcastTuning &tuning = BroadcastTuning::Global();
+  std::vector<char> buffer(std::max(max_bytes, std::size_t(1024)));
+
+  // среднее время рассылки size байт (максимум по процессам)
+  auto measure = [&](BroadcastAlgorithm algorithm, std::size_t size) {
+    int repeats = static_cast<int>(
+        Min(std::max((std::size_t(1) << 24) / size, std::size_t(3)),
+            std::size_t(50)));
+
+    parallel::TunedBroadcast(buffer.data(), static_cast<int>(size), MPI_BYTE,
+                             0, comm, algorithm);
+    parallel::CheckSuccess(MPI_Barrier(comm));
+
+    double start = MPI_Wtime();
+    for (int i = 0; i < repeats; i++)
+      parallel::TunedBroadcast(buffer.data(), static_cast<int>(size), MPI_BYTE,
+                               0, comm, algorithm);
+    double time = (MPI_Wtime() - start) / repeats;
+
+    parallel::CheckSuccess(
+        MPI_Allreduce(MPI_IN_PLACE, &time, 1, MPI_DOUBLE, MPI_MAX, comm));
+
+    return time;
+  };
+
+  std::size_t largest = buffer.size();
+  std::size_t best_segment = 16 * 1024;
+  double best_segment_time = -1.0;
+
+  for (std::size_t segment = 16 * 1024; segment <= 256 * 1024; segment *= 4) {
+    tuning.segment_bytes = segment;
+    double time = measure(BroadcastAlgorithm::Chain, largest);
+
+    if (best_segment_time < 0 || time < best_segment_time) {
+      best_segment_time = time;
+      best_segment = segment;
+    }
+  }
+
+  tuning.segment_bytes = best_segment;
+
+  tuning.min_ranks = 0;
+  tuning.binomial_max_bytes = 0;
+  tuning.chain_min_bytes = SIZE_MAX;
+
+  for (std::size_t size = 1024; size <= largest; size *= 4) {
+    double binomial = measure(BroadcastAlgorithm::Binomial, size);
+    double scatter = measure(BroadcastAlgorithm::ScatterAllGather, size);
+    double chain = measure(BroadcastAlgorithm::Chain, size);
+
+    if (binomial <= Min(scatter, chain) &&
+        tuning.chain_min_bytes == SIZE_MAX)
+      tuning.binomial_max_bytes = size;
+    else if (chain < scatter && tuning.chain_min_bytes == SIZE_MAX)
+      tuning.chain_min_bytes = size;
+  }
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+
+  return tuning;
+}
+
+/**
+ * @brief Начинает неблокирующую рассылку значения всем процессам в сети MPI
+ * (MPI_Ibcast).
+ * @tparam T: тип значения.
+ * @param value: рассылаемое значение (должно жить до завершения операции).
+ * @param datatype: тип данных значения.
+ * @param from_rank: ранг процесса, который рассылает значение. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ * @return parallel::Request: дескриптор операции.
+ */
+template <typename T>
+inline Request IBroadcast(T &value, MPI_Datatype datatype, int from_rank = 0,
+                          MPI_Comm comm = MPI_COMM_WORLD,
+                          bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::IBroadcast with args: value: " << value
+              << "; datatype: " << datatype << "; from_rank: " << from_rank
+              << "; comm: " << comm;
+
+  Request request;
+  parallel::CheckSuccess(
+      MPI_Ibcast(&value, 1, datatype, from_rank, comm, &request.Handle()));
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+
+  return request;
+}
+
+/**
+ * @brief Начинает неблокирующую рассылку массива всем процессам в сети MPI
+ * (MPI_Ibcast).
+ * @tparam T: тип элементов массива.
+ * @param arr: рассылаемый массив (должен жить до завершения операции).
+ * @param arr_len: количество элементов в массиве.
+ * @param datatype: тип данных элементов массива.
+ * @param from_rank: ранг процесса, который рассылает массив. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ * @return parallel::Request: дескриптор операции.
+ */
+template <typename T>
+inline Request IBroadcast(T *arr, int arr_len, MPI_Datatype datatype,
+                          int from_rank = 0, MPI_Comm comm = MPI_COMM_WORLD,
+                          bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::IBroadcast with args: arr: " << arr
+              << "; arr_len: " << arr_len << "; datatype: " << datatype
+              << "; from_rank: " << from_rank << "; comm: " << comm;
+
+  if (arr_len < 0)
+    parallel::Error("parallel::IBroadcast: arr_len should be non-negative.");
+
+  Request request;
+  parallel::CheckSuccess(MPI_Ibcast(arr, arr_len, datatype, from_rank, comm,
+                                    &request.Handle()));
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+
+  return request;
+}
+
+/**
+ * @brief Начинает неблокирующую рассылку вектора всем процессам в сети MPI
+ * (MPI_Ibcast).
+ * @tparam T: тип элементов вектора.
+ * @param vec: рассылаемый вектор (должен жить и не менять размер до
+ * завершения операции).
+ * @param datatype: тип данных элементов вектора.
+ * @param from_rank: ранг процесса, который рассылает вектор. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ * @return parallel::Request: дескриптор операции.
+ */
+template <typename T>
+inline Request IBroadcast(std::vector<T> &vec, MPI_Datatype datatype,
+                          int from_rank = 0, MPI_Comm comm = MPI_COMM_WORLD,
+                          bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::IBroadcast with args: vec: " << vec
+              << "; datatype: " << datatype << "; from_rank: " << from_rank
+              << "; comm: " << comm;
+
+  if (vec.size() > INT_MAX)
+    parallel::Error(
+        "parallel::IBroadcast: vector is too big (size > INT_MAX).");
+
+  Request request = parallel::IBroadcast(
+      vec.data(), static_cast<int>(vec.size()), datatype, from_rank, comm);
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+
+  return request;
+}
+
+/**
+ * @brief Начинает неблокирующую рассылку значения всем процессам в сети MPI
+ * (тип данных выводится из T).
+ * @tparam T: тип значения.
+ * @param value: рассылаемое значение (должно жить до завершения операции).
+ * @param from_rank: ранг процесса, который рассылает значение. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ * @return parallel::Request: дескриптор операции.
+ */
+template <typename T,
+          typename = typename std::enable_if<is_mpi_type<T>::value>::type>
+inline Request IBroadcast(T &value, int from_rank = 0,
+                          MPI_Comm comm = MPI_COMM_WORLD,
+                          bool need_print = false) {
+  return parallel::IBroadcast(&value, 1, mpi_type<T>::get(), from_rank, comm,
+                              need_print);
+}
+
+/**
+ * @brief Начинает неблокирующую рассылку массива всем процессам в сети MPI
+ * (тип данных выводится из T).
+ * @tparam T: тип элементов массива.
+ * @param arr: рассылаемый массив (должен жить до завершения операции).
+ * @param arr_len: количество элементов в массиве.
+ * @param from_rank: ранг процесса, который рассылает массив. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ * @return parallel::Request: дескриптор операции.
+ */
+template <typename T>
+inline Request IBroadcast(T *arr, int arr_len, int from_rank = 0,
+                          MPI_Comm comm = MPI_COMM_WORLD,
+                          bool need_print = false) {
+  return parallel::IBroadcast(arr, arr_len, mpi_type<T>::get(), from_rank,
+                              comm, need_print);
+}
+
+/**
+ * @brief Начинает неблокирующую рассылку вектора всем процессам в сети MPI
+ * (тип данных выводится из T).
+ * @tparam T: тип элементов вектора.
+ * @param vec: рассылаемый вектор (должен жить и не менять размер до
+ * завершения операции).
+ * @param from_rank: ранг процесса, который рассылает вектор. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ * @return parallel::Request: дескриптор операции.
+ */
+template <typename T>
+inline Request IBroadcast(std::vector<T> &vec, int from_rank = 0,
+                          MPI_Comm comm = MPI_COMM_WORLD,
+                          bool need_print = false) {
+  if (vec.size() > INT_MAX)
+    parallel::Error(
+        "parallel::IBroadcast: vector is too big (size > INT_MAX).");
+
+  return parallel::IBroadcast(vec.data(), static_cast<int>(vec.size()),
+                              mpi_type<T>::get(), from_rank, comm, need_print);
+}
+
+/**
+ * @brief Выполняет операцию над значением и отправляет результат на
+ * указанный процесс в сети MPI.
+ * @tparam T: тип значения.
+ * @param from_value: исходное значение, над которым выполняется операция.
+ * @param to_value: значение, куда будет записан результат операции.
+ * @param datatype: тип данных значения.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param to_rank: ранг процесса результата. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void Operation(const T &from_value, T &to_value, MPI_Datatype datatype,
+                      MPI_Op op, unsigned int to_rank = 0,
+                      MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::Operation with args: from_value: " << from_value
+              << "; to_value: " << to_value << "; datatype: " << datatype
+              << "; op: " << op << "; to_rank: " << to_rank
+              << "; comm: " << comm;
+
+  parallel::CheckSuccess(
+      MPI_Reduce(&from_value, &to_value, 1, datatype, op, to_rank, comm));
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Выполняет операцию над массивом значений и отправляет результат на
+ * указанный процесс в сети MPI.
+ * @tparam T: тип значения в массиве.
+ * @param from_arr: исходный массив значений, над которым выполняется операция.
+ * @param to_arr: массив, куда будет записан результат операции.
+ * @param arr_len: количество элементов в массиве.
+ * @param datatype: тип данных элементов массива.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param to_rank: ранг процесса результата. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void Operation(const T *from_arr, T *to_arr, int arr_len,
+                      MPI_Datatype datatype, MPI_Op op,
+                      unsigned int to_rank = 0, MPI_Comm comm = MPI_COMM_WORLD,
+                      bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::Operation with args: from_arr: " << from_arr
+              << "; to_arr: " << to_arr << "; arr_len: " << arr_len
+              << "; datatype: " << datatype << "; op: " << op
+              << "; to_rank: " << to_rank << "; comm: " << comm;
+
+  if (arr_len <= 0)
+    parallel::Error("parallel::Operation: arr_len should be non-negative.");
+
+  parallel::CheckSuccess(
+      MPI_Reduce(from_arr, to_arr, arr_len, datatype, op, to_rank, comm));
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Выполняет операцию над вектором значений и отправляет результат на
+ * указанный процесс в сети MPI.
+ * @tparam T: тип значения в векторе.
+ * @param from_vec: исходный вектор значений, над которым выполняется операция.
+ * @param to_vec: вектор, куда будет записан результат операции.
+ * @param datatype: тип данных в векторе.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param to_rank: ранг процесса результата. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void Operation(const std::vector<T> &from_vec, std::vector<T> &to_vec,
+                      MPI_Datatype datatype, MPI_Op op,
+                      unsigned int to_rank = 0, MPI_Comm comm = MPI_COMM_WORLD,
+                      bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::Operation with args: from_vec: " << from_vec
+              << "; to_vec: " << to_vec << "; datatype: " << datatype
+              << "; op: " << op << "; to_rank: " << to_rank
+              << "; comm: " << comm;
+
+  // длина берётся только из from_vec (она одинакова на всех процессах),
+  // иначе процессы могли бы выбрать разные пути
+  std::size_t arr_len = from_vec.size();
+
+  if (parallel::CurrRank(comm) == static_cast<int>(to_rank) &&
+      to_vec.size() < arr_len)
+    to_vec.resize(arr_len);
+
+  if (arr_len > PARALLEL_MAX_COUNT)
+    parallel::OperationLarge(from_vec.data(), to_vec.data(), arr_len, datatype,
+                             op, to_rank, comm);
+  else
+    parallel::Operation(from_vec.data(), to_vec.data(),
+                        static_cast<int>(arr_len), datatype, op, to_rank, comm);
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Выполняет операцию над значением и отправляет результат на
+ * указанный процесс в сети MPI (тип данных выводится из T).
+ * @tparam T: тип значения.
+ * @param from_value: исходное значение, над которым выполняется операция.
+ * @param to_value: значение, куда будет записан результат операции.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param to_rank: ранг процесса результата. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T,
+          typename = typename std::enable_if<is_mpi_type<T>::value>::type>
+inline void Operation(const T &from_value, T &to_value, MPI_Op op,
+                      unsigned int to_rank = 0, MPI_Comm comm = MPI_COMM_WORLD,
+                      bool need_print = false) {
+  parallel::Operation(&from_value, &to_value, 1, mpi_type<T>::get(), op,
+                      to_rank, comm, need_print);
+}
+
+/**
+ * @brief Выполняет операцию над массивом значений и отправляет результат на
+ * указанный процесс в сети MPI (тип данных выводится из T).
+ * @tparam T: тип значения в массиве.
+ * @param from_arr: исходный массив значений, над которым выполняется операция.
+ * @param to_arr: массив, куда будет записан результат операции.
+ * @param arr_len: количество элементов в массиве.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param to_rank: ранг процесса результата. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void Operation(const T *from_arr, T *to_arr, int arr_len, MPI_Op op,
+                      unsigned int to_rank = 0, MPI_Comm comm = MPI_COMM_WORLD,
+                      bool need_print = false) {
+  parallel::Operation(from_arr, to_arr, arr_len, mpi_type<T>::get(), op,
+                      to_rank, comm, need_print);
+}
+
+/**
+ * @brief Выполняет операцию над вектором значений и отправляет результат на
+ * указанный процесс в сети MPI (тип данных выводится из T).
+ * @tparam T: тип значения в векторе.
+ * @param from_vec: исходный вектор значений, над которым выполняется операция.
+ * @param to_vec: вектор, куда будет записан результат операции.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param to_rank: ранг процесса результата. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void Operation(const std::vector<T> &from_vec, std::vector<T> &to_vec,
+                      MPI_Op op, unsigned int to_rank = 0,
+                      MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
+  parallel::Operation(from_vec, to_vec, mpi_type<T>::get(), op, to_rank, comm,
+                      need_print);
+}
+
+/**
+ * @brief Выполняет операцию над значением и рассылает результат всем
+ * процессам в сети MPI (MPI_Allreduce).
+ * @tparam T: тип значения.
+ * @param from_value: исходное значение, над которым выполняется операция.
+ * @param to_value: значение, куда будет записан результат операции.
+ * @param datatype: тип данных значения.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void AllOperation(const T &from_value, T &to_value,
+                         MPI_Datatype datatype, MPI_Op op,
+                         MPI_Comm comm = MPI_COMM_WORLD,
+                         bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::AllOperation with args: from_value: " << from_value
+              << "; to_value: " << to_value << "; datatype: " << datatype
+              << "; op: " << op << "; comm: " << comm;
+
+  parallel::CheckSuccess(
+      MPI_Allreduce(&from_value, &to_value, 1, datatype, op, comm));
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Выполняет операцию над значением и записывает результат на его
+ * место во всех процессах в сети MPI (MPI_Allreduce с MPI_IN_PLACE).
+ * @tparam T: тип значения.
+ * @param value: исходное значение и результат операции.
+ * @param datatype: тип данных значения.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void AllOperation(T &value, MPI_Datatype datatype, MPI_Op op,
+                         MPI_Comm comm = MPI_COMM_WORLD,
+                         bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::AllOperation with args: value: " << value
+              << "; datatype: " << datatype << "; op: " << op
+              << "; comm: " << comm;
+
+  parallel::CheckSuccess(
+      MPI_Allreduce(MPI_IN_PLACE, &value, 1, datatype, op, comm));
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Выполняет операцию над массивом значений и рассылает результат
+ * всем процессам в сети MPI (MPI_Allreduce).
+ * @details Если from_arr совпадает с to_arr, используется MPI_IN_PLACE.
+ * @tparam T: тип значения в массиве.
+ * @param from_arr: исходный массив значений, над которым выполняется операция.
+ * @param to_arr: массив, куда будет записан результат операции.
+ * @param arr_len: количество элементов в массиве.
+ * @param datatype: тип данных элементов массива.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void AllOperation(const T *from_arr, T *to_arr, int arr_len,
+                         MPI_Datatype datatype, MPI_Op op,
+                         MPI_Comm comm = MPI_COMM_WORLD,
+                         bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::AllOperation with args: from_arr: " << from_arr
+              << "; to_arr: " << to_arr << "; arr_len: " << arr_len
+              << "; datatype: " << datatype << "; op: " << op
+              << "; comm: " << comm;
+
+  if (arr_len <= 0)
+    parallel::Error("parallel::AllOperation: arr_len should be non-negative.");
+
+  parallel::CheckSuccess(
+      MPI_Allreduce(from_arr == to_arr ? MPI_IN_PLACE : from_arr, to_arr,
+                    arr_len, datatype, op, comm));
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Выполняет операцию над массивом значений и записывает результат на
+ * его место во всех процессах в сети MPI (MPI_Allreduce с MPI_IN_PLACE).
+ * @tparam T: тип значения в массиве.
+ * @param arr: исходный массив значений и результат операции.
+ * @param arr_len: количество элементов в массиве.
+ * @param datatype: тип данных элементов массива.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void AllOperation(T *arr, int arr_len, MPI_Datatype datatype,
+                         MPI_Op op, MPI_Comm comm = MPI_COMM_WORLD,
+                         bool need_print = false) {
+  parallel::AllOperation(arr, arr, arr_len, datatype, op, comm, need_print);
+}
+
+/**
+ * @brief Выполняет операцию над вектором значений и рассылает результат
+ * всем процессам в сети MPI (MPI_Allreduce).
+ * @tparam T: тип значения в векторе.
+ * @param from_vec: исходный вектор значений, над которым выполняется операция.
+ * @param to_vec: вектор, куда будет записан результат операции.
+ * @param datatype: тип данных в векторе.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void AllOperation(const std::vector<T> &from_vec,
+                         std::vector<T> &to_vec, MPI_Datatype datatype,
+                         MPI_Op op, MPI_Comm comm = MPI_COMM_WORLD,
+                         bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::AllOperation with args: from_vec: " << from_vec
+              << "; to_vec: " << to_vec << "; datatype: " << datatype
+              << "; op: " << op << "; comm: " << comm;
+
+  std::size_t arr_len = from_vec.size();
+
+  if (to_vec.size() < arr_len) to_vec.resize(arr_len);
+
+  if (arr_len > PARALLEL_MAX_COUNT)
+    parallel::AllOperationLarge(from_vec.data(), to_vec.data(), arr_len,
+                                datatype, op, comm);
+  else
+    parallel::AllOperation(from_vec.data(), to_vec.data(),
+                           static_cast<int>(arr_len), datatype, op, comm);
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Выполняет операцию над вектором значений и записывает результат на
+ * его место во всех процессах в сети MPI (MPI_Allreduce с MPI_IN_PLACE).
+ * @tparam T: тип значения в векторе.
+ * @param vec: исходный вектор значений и результат операции.
+ * @param datatype: тип данных в векторе.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void AllOperation(std::vector<T> &vec, MPI_Datatype datatype, MPI_Op op,
+                         MPI_Comm comm = MPI_COMM_WORLD,
+                         bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::AllOperation with args: vec: " << vec
+              << "; datatype: " << datatype << "; op: " << op
+              << "; comm: " << comm;
+
+  if (vec.size() > PARALLEL_MAX_COUNT)
+    parallel::AllOperationLarge(vec.data(), vec.data(), vec.size(), datatype,
+                                op, comm);
+  else
+    parallel::AllOperation(vec.data(), static_cast<int>(vec.size()), datatype,
+                           op, comm);
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Выполняет операцию над значением и рассылает результат всем
+ * процессам в сети MPI (тип данных выводится из T).
+ * @tparam T: тип значения.
+ * @param from_value: исходное значение, над которым выполняется операция.
+ * @param to_value: значение, куда будет записан результат операции.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T,
+          typename = typename std::enable_if<is_mpi_type<T>::value>::type>
+inline void AllOperation(const T &from_value, T &to_value, MPI_Op op,
+                         MPI_Comm comm = MPI_COMM_WORLD,
+                         bool need_print = false) {
+  parallel::AllOperation(&from_value, &to_value, 1, mpi_type<T>::get(), op,
+                         comm, need_print);
+}
+
+/**
+ * @brief Выполняет операцию над значением и записывает результат на его
+ * место во всех процессах в сети MPI (тип данных выводится из T).
+ * @tparam T: тип значения.
+ * @param value: исходное значение и результат операции.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T,
+          typename = typename std::enable_if<is_mpi_type<T>::value>::type>
+inline void AllOperation(T &value, MPI_Op op, MPI_Comm comm = MPI_COMM_WORLD,
+                         bool need_print = false) {
+  parallel::AllOperation(&value, 1, mpi_type<T>::get(), op, comm, need_print);
+}
+
+/**
+ * @brief Выполняет операцию над массивом значений и рассылает результат
+ * всем процессам в сети MPI (тип данных выводится из T).
+ * @tparam T: тип значения в массиве.
+ * @param from_arr: исходный массив значений, над которым выполняется операция.
+ * @param to_arr: массив, куда будет записан результат операции.
+ * @param arr_len: количество элементов в массиве.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void AllOperation(const T *from_arr, T *to_arr, int arr_len, MPI_Op op,
+                         MPI_Comm comm = MPI_COMM_WORLD,
+                         bool need_print = false) {
+  parallel::AllOperation(from_arr, to_arr, arr_len, mpi_type<T>::get(), op,
+                         comm, need_print);
+}
+
+/**
+ * @brief Выполняет операцию над массивом значений и записывает результат на
+ * его место во всех процессах в сети MPI (тип данных выводится из T).
+ * @tparam T: тип значения в массиве.
+ * @param arr: исходный массив значений и результат операции.
+ * @param arr_len: количество элементов в массиве.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void AllOperation(T *arr, int arr_len, MPI_Op op,
+                         MPI_Comm comm = MPI_COMM_WORLD,
+                         bool need_print = false) {
+  parallel::AllOperation(arr, arr, arr_len, mpi_type<T>::get(), op, comm,
+                         need_print);
+}
+
+/**
+ * @brief Выполняет операцию над вектором значений и рассылает результат
+ * всем процессам в сети MPI (тип данных выводится из T).
+ * @tparam T: тип значения в векторе.
+ * @param from_vec: исходный вектор значений, над которым выполняется операция.
+ * @param to_vec: вектор, куда будет записан результат операции.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void AllOperation(const std::vector<T> &from_vec,
+                         std::vector<T> &to_vec, MPI_Op op,
+                         MPI_Comm comm = MPI_COMM_WORLD,
+                         bool need_print = false) {
+  parallel::AllOperation(from_vec, to_vec, mpi_type<T>::get(), op, comm,
+                         need_print);
+}
+
+/**
+ * @brief Выполняет операцию над вектором значений и записывает результат на
+ * его место во всех процессах в сети MPI (тип данных выводится из T).
+ * @tparam T: тип значения в векторе.
+ * @param vec: исходный вектор значений и результат операции.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void AllOperation(std::vector<T> &vec, MPI_Op op,
+                         MPI_Comm comm = MPI_COMM_WORLD,
+                         bool need_print = false) {
+  if (vec.size() > PARALLEL_MAX_COUNT)
+    parallel::AllOperationLarge(vec.data(), vec.data(), vec.size(),
+                                mpi_type<T>::get(), op, comm);
+  else
+    parallel::AllOperation(vec.data(), static_cast<int>(vec.size()),
+                           mpi_type<T>::get(), op, comm, need_print);
+}
+
+/**
+ * @brief Воспроизводимо суммирует частичные суммы процессов и отправляет
+ * округлённый результат на указанный процесс в сети MPI.
+ * @details В отличие от MPI_SUM над double, результат побитово совпадает
+ * при любом числе процессов и разбиении слагаемых между ними.
+ * @param from_sum: частичная сумма процесса.
+ * @param to_value: значение, куда будет записана сумма.
+ * @param to_rank: ранг процесса результата. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+inline void Operation(const ReproducibleSum &from_sum, double &to_value,
+                      unsigned int to_rank = 0, MPI_Comm comm = MPI_COMM_WORLD,
+                      bool need_print = false) {
+  ReproducibleSum to_sum;
+
+  parallel::Operation(from_sum, to_sum, ReproducibleSumOperation(), to_rank,
+                      comm, need_print);
+
+  if (CurrRank(comm) == static_cast<int>(to_rank)) to_value = to_sum.Value();
+}
+
+/**
+ * @brief Воспроизводимо суммирует частичные суммы процессов и рассылает
+ * округлённый результат всем процессам в сети MPI.
+ * @param from_sum: частичная сумма процесса.
+ * @param to_value: значение, куда будет записана сумма.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+inline void AllOperation(const ReproducibleSum &from_sum, double &to_value,
+                         MPI_Comm comm = MPI_COMM_WORLD,
+                         bool need_print = false) {
+  ReproducibleSum to_sum;
+
+  parallel::AllOperation(from_sum, to_sum, ReproducibleSumOperation(), comm,
+                         need_print);
+
+  to_value = to_sum.Value();
+}
+
+/**
+ * @brief Выполняет префиксную операцию над массивами значений процессов:
+ * процесс ранга i получает результат операции над массивами процессов
+ * 0, ..., i (MPI_Scan или MPI_Exscan).
+ * @details Операция применяется поэлементно в порядке рангов, поэтому
+ * допускаются некоммутативные операции. При исключающем варианте на
+ * процессе ранга 0 массив to_arr не изменяется: в нём остаются значения,
+ * которыми его заполнил вызывающий (обычно нейтральный элемент операции).
+ * @tparam T: тип значения в массиве.
+ * @param from_arr: исходный массив значений процесса.
+ * @param to_arr: массив, куда будет записан результат операции.
+ * @param arr_len: количество элементов в массиве.
+ * @param datatype: тип данных элементов массива.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param is_exclusive: исключать ли значения самого процесса.
+ * @param comm: коммуникатор MPI.
+ */
+template <typename T>
+inline void ScanArray(const T *from_arr, T *to_arr, int arr_len,
+                      MPI_Datatype datatype, MPI_Op op, bool is_exclusive,
+                      MPI_Comm comm) {
+  if (arr_len < 0)
+    parallel::Error("parallel::Scan: arr_len should be non-negative.");
+
+  if (!is_exclusive) {
+    parallel::CheckSuccess(
+        MPI_Scan(from_arr, to_arr, arr_len, datatype, op, comm));
+    return;
+  }
+
+  // MPI_Exscan не определяет результат на процессе ранга 0
+  bool is_first = parallel::CurrRank(comm) == 0;
+
+  PooledBuffer<char> unused(is_first ? arr_len * sizeof(T) : 0);
+  T *recv_arr = is_first ? reinterpret_cast<T *>(unused.Data()) : to_arr;
+
+  parallel::CheckSuccess(
+      MPI_Exscan(from_arr, recv_arr, arr_len, datatype, op, comm));
+}
+
+/**
+ * @brief Выполняет префиксную операцию над векторами произвольной длины
+ * частями не длиннее PARALLEL_MAX_COUNT элементов (см. parallel::ScanArray).
+ * @tparam T: тип значения в векторе.
+ * @param from_vec: исходный вектор значений процесса.
+ * @param to_vec: вектор, куда будет записан результат операции.
+ * @param datatype: тип данных в векторе.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param is_exclusive: исключать ли значения самого процесса.
+ * @param comm: коммуникатор MPI.
+ */
+template <typename T>
+inline void ScanVector(const std::vector<T> &from_vec, std::vector<T> &to_vec,
+                       MPI_Datatype datatype, MPI_Op op, bool is_exclusive,
+                       MPI_Comm comm) {
+  std::size_t arr_len = Min(from_vec.size(), to_vec.size());
+
+  for (std::size_t begin = 0; begin < arr_len; begin += PARALLEL_MAX_COUNT) {
+    std::size_t part_len =
+        Min(arr_len - begin, static_cast<std::size_t>(PARALLEL_MAX_COUNT));
+
+    parallel::ScanArray(from_vec.data() + begin, to_vec.data() + begin,
+                        static_cast<int>(part_len), datatype, op, is_exclusive,
+                        comm);
+  }
+}
+
+/**
+ * @brief Выполняет операцию над значениями процессов 0, ..., i и записывает
+ * результат на процесс ранга i (включающий префикс, MPI_Scan).
+ * @details Позволяет за одну коллективную операцию глубины O(log P)
+ * получить, например, накопленные суммы размеров частей без сбора
+ * размеров на одном процессе.
+ * @tparam T: тип значения.
+ * @param from_value: исходное значение процесса.
+ * @param to_value: значение, куда будет записан результат операции.
+ * @param datatype: тип данных значения.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void Scan(const T &from_value, T &to_value, MPI_Datatype datatype,
+                 MPI_Op op, MPI_Comm comm = MPI_COMM_WORLD,
+                 bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::Scan with args: from_value: " << from_value
+              << "; to_value: " << to_value << "; datatype: " << datatype
+              << "; op: " << op << "; comm: " << comm;
+
+  parallel::ScanArray(&from_value, &to_value, 1, datatype, op, false, comm);
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Выполняет поэлементную операцию над массивами процессов
+ * 0, ..., i и записывает результат на процесс ранга i (MPI_Scan).
+ * @tparam T: тип значения в массиве.
+ * @param from_arr: исходный массив значений процесса.
+ * @param to_arr: массив, куда будет записан результат операции.
+ * @param arr_len: количество элементов в массиве.
+ * @param datatype: тип данных элементов массива.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void Scan(const T *from_arr, T *to_arr, int arr_len,
+                 MPI_Datatype datatype, MPI_Op op,
+                 MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::Scan with args: from_arr: " << from_arr
+              << "; to_arr: " << to_arr << "; arr_len: " << arr_len
+              << "; datatype: " << datatype << "; op: " << op
+              << "; comm: " << comm;
+
+  parallel::ScanArray(from_arr, to_arr, arr_len, datatype, op, false, comm);
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Выполняет поэлементную операцию над векторами процессов
+ * 0, ..., i и записывает результат на процесс ранга i (MPI_Scan).
+ * @tparam T: тип значения в векторе.
+ * @param from_vec: исходный вектор значений процесса.
+ * @param to_vec: вектор, куда будет записан результат операции.
+ * @param datatype: тип данных в векторе.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void Scan(const std::vector<T> &from_vec, std::vector<T> &to_vec,
+                 MPI_Datatype datatype, MPI_Op op,
+                 MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::Scan with args: from_vec: " << from_vec
+              << "; to_vec: " << to_vec << "; datatype: " << datatype
+              << "; op: " << op << "; comm: " << comm;
+
+  parallel::ScanVector(from_vec, to_vec, datatype, op, false, comm);
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Выполняет операцию над значениями процессов 0, ..., i и записывает
+ * результат на процесс ранга i (тип данных выводится из T).
+ * @tparam T: тип значения.
+ * @param from_value: исходное значение процесса.
+ * @param to_value: значение, куда будет записан результат операции.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T,
+          typename = typename std::enable_if<is_mpi_type<T>::value>::type>
+inline void Scan(const T &from_value, T &to_value, MPI_Op op,
+                 MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
+  parallel::Scan(&from_value, &to_value, 1, mpi_type<T>::get(), op, comm,
+                 need_print);
+}
+
+/**
+ * @brief Выполняет поэлементную операцию над массивами процессов
+ * 0, ..., i и записывает результат на процесс ранга i (тип данных
+ * выводится из T).
+ * @tparam T: тип значения в массиве.
+ * @param from_arr: исходный массив значений процесса.
+ * @param to_arr: массив, куда будет записан результат операции.
+ * @param arr_len: количество элементов в массиве.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void Scan(const T *from_arr, T *to_arr, int arr_len, MPI_Op op,
+                 MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
+  parallel::Scan(from_arr, to_arr, arr_len, mpi_type<T>::get(), op, comm,
+                 need_print);
+}
+
+/**
+ * @brief Выполняет поэлементную операцию над векторами процессов
+ * 0, ..., i и записывает результат на процесс ранга i (тип данных
+ * выводится из T).
+ * @tparam T: тип значения в векторе.
+ * @param from_vec: исходный вектор значений процесса.
+ * @param to_vec: вектор, куда будет записан результат операции.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void Scan(const std::vector<T> &from_vec, std::vector<T> &to_vec,
+                 MPI_Op op, MPI_Comm comm = MPI_COMM_WORLD,
+                 bool need_print = false) {
+  parallel::Scan(from_vec, to_vec, mpi_type<T>::get(), op, comm, need_print);
+}
+
+/**
+ * @brief Выполняет над значениями процессов 0, ..., i операцию, заданную
+ * функтором C++, и записывает результат на процесс ранга i.
+ * @details Функтор регистрируется как некоммутативная операция (см.
+ * parallel::UserOperation): functor(a, b) получает в a накопленное значение
+ * процессов с меньшими рангами.
+ * @tparam T: тип значения.
+ * @tparam F: тип функтора T(const T& a, const T& b).
+ * @param from_value: исходное значение процесса.
+ * @param to_value: значение, куда будет записан результат операции.
+ * @param functor: функтор операции.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T, typename F,
+          typename = typename std::enable_if<is_mpi_type<T>::value>::type>
+inline void Scan(const T &from_value, T &to_value, const F &functor,
+                 MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
+  parallel::Scan(&from_value, &to_value, 1, mpi_type<T>::get(),
+                 UserOperation<T>(functor, false), comm, need_print);
+}
+
+/**
+ * @brief Выполняет над массивами процессов 0, ..., i поэлементную операцию,
+ * заданную функтором C++, и записывает результат на процесс ранга i.
+ * @tparam T: тип значения в массиве.
+ * @tparam F: тип функтора T(const T& a, const T& b).
+ * @param from_arr: исходный массив значений процесса.
+ * @param to_arr: массив, куда будет записан результат операции.
+ * @param arr_len: количество элементов в массиве.
+ * @param functor: функтор операции.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T, typename F>
+inline void Scan(const T *from_arr, T *to_arr, int arr_len, const F &functor,
+                 MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
+  parallel::Scan(from_arr, to_arr, arr_len, mpi_type<T>::get(),
+                 UserOperation<T>(functor, false), comm, need_print);
+}
+
+/**
+ * @brief Выполняет над векторами процессов 0, ..., i поэлементную операцию,
+ * заданную функтором C++, и записывает результат на процесс ранга i.
+ * @tparam T: тип значения в векторе.
+ * @tparam F: тип функтора T(const T& a, const T& b).
+ * @param from_vec: исходный вектор значений процесса.
+ * @param to_vec: вектор, куда будет записан результат операции.
+ * @param functor: функтор операции.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T, typename F>
+inline void Scan(const std::vector<T> &from_vec, std::vector<T> &to_vec,
+                 const F &functor, MPI_Comm comm = MPI_COMM_WORLD,
+                 bool need_print = false) {
+  parallel::Scan(from_vec, to_vec, mpi_type<T>::get(),
+                 UserOperation<T>(functor, false), comm, need_print);
+}
+
+/**
+ * @brief Выполняет операцию над значениями процессов 0, ..., i - 1 и
+ * записывает результат на процесс ранга i (исключающий префикс, MPI_Exscan).
+ * @details Так за одну коллективную операцию вычисляется смещение части
+ * процесса в глобальном массиве: ExclusiveScan(size, offset, MPI_SUM). На
+ * процессе ранга 0 to_value не изменяется, поэтому его следует заранее
+ * заполнить нейтральным элементом операции.
+ * @tparam T: тип значения.
+ * @param from_value: исходное значение процесса.
+ * @param to_value: значение, куда будет записан результат операции.
+ * @param datatype: тип данных значения.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void ExclusiveScan(const T &from_value, T &to_value,
+                          MPI_Datatype datatype, MPI_Op op,
+                          MPI_Comm comm = MPI_COMM_WORLD,
+                          bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::ExclusiveScan with args: from_value: "
+              << from_value << "; to_value: " << to_value
+              << "; datatype: " << datatype << "; op: " << op
+              << "; comm: " << comm;
+
+  parallel::ScanArray(&from_value, &to_value, 1, datatype, op, true, comm);
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Выполняет поэлементную операцию над массивами процессов
+ * 0, ..., i - 1 и записывает результат на процесс ранга i (MPI_Exscan).
+ * @details На процессе ранга 0 to_arr не изменяется.
+ * @tparam T: тип значения в массиве.
+ * @param from_arr: исходный массив значений процесса.
+ * @param to_arr: массив, куда будет записан результат операции.
+ * @param arr_len: количество элементов в массиве.
+ * @param datatype: тип данных элементов массива.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void ExclusiveScan(const T *from_arr, T *to_arr, int arr_len,
+                          MPI_Datatype datatype, MPI_Op op,
+                          MPI_Comm comm = MPI_COMM_WORLD,
+                          bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::ExclusiveScan with args: from_arr: " << from_arr
+              << "; to_arr: " << to_arr << "; arr_len: " << arr_len
+              << "; datatype: " << datatype << "; op: " << op
+              << "; comm: " << comm;
+
+  parallel::ScanArray(from_arr, to_arr, arr_len, datatype, op, true, comm);
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Выполняет поэлементную операцию над векторами процессов
+ * 0, ..., i - 1 и записывает результат на процесс ранга i (MPI_Exscan).
+ * @details На процессе ранга 0 to_vec не изменяется.
+ * @tparam T: тип значения в векторе.
+ * @param from_vec: исходный вектор значений процесса.
+ * @param to_vec: вектор, куда будет записан результат операции.
+ * @param datatype: тип данных в векторе.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void ExclusiveScan(const std::vector<T> &from_vec,
+                          std::vector<T> &to_vec, MPI_Datatype datatype,
+                          MPI_Op op, MPI_Comm comm = MPI_COMM_WORLD,
+                          bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::ExclusiveScan with args: from_vec: " << from_vec
+              << "; to_vec: " << to_vec << "; datatype: " << datatype
+              << "; op: " << op << "; comm: " << comm;
+
+  parallel::ScanVector(from_vec, to_vec, datatype, op, true, comm);
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Выполняет операцию над значениями процессов 0, ..., i - 1 и
+ * записывает результат на процесс ранга i (тип данных выводится из T).
+ * @details На процессе ранга 0 to_value не изменяется.
+ * @tparam T: тип значения.
+ * @param from_value: исходное значение процесса.
+ * @param to_value: значение, куда будет записан результат операции.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T,
+          typename = typename std::enable_if<is_mpi_type<T>::value>::type>
+inline void ExclusiveScan(const T &from_value, T &to_value, MPI_Op op,
+                          MPI_Comm comm = MPI_COMM_WORLD,
+                          bool need_print = false) {
+  parallel::ExclusiveScan(&from_value, &to_value, 1, mpi_type<T>::get(), op,
+                          comm, need_print);
+}
+
+/**
+ * @brief Выполняет поэлементную операцию над массивами процессов
+ * 0, ..., i - 1 и записывает результат на процесс ранга i (тип данных
+ * выводится из T).
+ * @details На процессе ранга 0 to_arr не изменяется.
+ * @tparam T: тип значения в массиве.
+ * @param from_arr: исходный массив значений процесса.
+ * @param to_arr: массив, куда будет записан результат операции.
+ * @param arr_len: количество элементов в массиве.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void ExclusiveScan(const T *from_arr, T *to_arr, int arr_len,
+                          MPI_Op op, MPI_Comm comm = MPI_COMM_WORLD,
+                          bool need_print = false) {
+  parallel::ExclusiveScan(from_arr, to_arr, arr_len, mpi_type<T>::get(), op,
+                          comm, need_print);
+}
+
+/**
+ * @brief Выполняет поэлементную операцию над векторами процессов
+ * 0, ..., i - 1 и записывает результат на процесс ранга i (тип данных
+ * выводится из T).
+ * @details На процессе ранга 0 to_vec не изменяется.
+ * @tparam T: тип значения в векторе.
+ * @param from_vec: исходный вектор значений процесса.
+ * @param to_vec: вектор, куда будет записан результат операции.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void ExclusiveScan(const std::vector<T> &from_vec,
+                          std::vector<T> &to_vec, MPI_Op op,
+                          MPI_Comm comm = MPI_COMM_WORLD,
+                          bool need_print = false) {
+  parallel::ExclusiveScan(from_vec, to_vec, mpi_type<T>::get(), op, comm,
+                          need_print);
+}
+
+/**
+ * @brief Выполняет над значениями процессов 0, ..., i - 1 операцию,
+ * заданную функтором C++, и записывает результат на процесс ранга i.
+ * @details На процессе ранга 0 to_value не изменяется. См. parallel::Scan.
+ * @tparam T: тип значения.
+ * @tparam F: тип функтора T(const T& a, const T& b).
+ * @param from_value: исходное значение процесса.
+ * @param to_value: значение, куда будет записан результат операции.
+ * @param functor: функтор операции.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T, typename F,
+          typename = typename std::enable_if<is_mpi_type<T>::value>::type>
+inline void ExclusiveScan(const T &from_value, T &to_value, const F &functor,
+                          MPI_Comm comm = MPI_COMM_WORLD,
+                          bool need_print = false) {
+  parallel::ExclusiveScan(&from_value, &to_value, 1, mpi_type<T>::get(),
+                          UserOperation<T>(functor, false), comm, need_print);
+}
+
+/**
+ * @brief Выполняет над массивами процессов 0, ..., i - 1 поэлементную
+ * операцию, заданную функтором C++, и записывает результат на процесс
+ * ранга i.
+ * @details На процессе ранга 0 to_arr не изменяется.
+ * @tparam T: тип значения в массиве.
+ * @tparam F: тип функтора T(const T& a, const T& b).
+ * @param from_arr: исходный массив значений процесса.
+ * @param to_arr: массив, куда будет записан результат операции.
+ * @param arr_len: количество элементов в массиве.
+ * @param functor: функтор операции.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T, typename F>
+inline void ExclusiveScan(const T *from_arr, T *to_arr, int arr_len,
+                          const F &functor, MPI_Comm comm = MPI_COMM_WORLD,
+                          bool need_print = false) {
+  parallel::ExclusiveScan(from_arr, to_arr, arr_len, mpi_type<T>::get(),
+                          UserOperation<T>(functor, false), comm, need_print);
+}
+
+/**
+ * @brief Выполняет над векторами процессов 0, ..., i - 1 поэлементную
+ * операцию, заданную функтором C++, и записывает результат на процесс
+ * ранга i.
+ * @details На процессе ранга 0 to_vec не изменяется.
+ * @tparam T: тип значения в векторе.
+ * @tparam F: тип функтора T(const T& a, const T& b).
+ * @param from_vec: исходный вектор значений процесса.
+ * @param to_vec: вектор, куда будет записан результат операции.
+ * @param functor: функтор операции.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T, typename F>
+inline void ExclusiveScan(const std::vector<T> &from_vec,
+                          std::vector<T> &to_vec, const F &functor,
+                          MPI_Comm comm = MPI_COMM_WORLD,
+                          bool need_print = false) {
+  parallel::ExclusiveScan(from_vec, to_vec, mpi_type<T>::get(),
+                          UserOperation<T>(functor, false), comm, need_print);
+}
+
+#ifdef _OPENMP
+/**
+ * @brief Префиксная операция над значениями всех нитей OpenMP всех
+ * процессов в порядке (ранг процесса, номер нити).
+ * @details Вызывается всеми нитями одной параллельной области (или вне
+ * её - тогда как одна нить). Сначала главная нить последовательно
+ * сворачивает значения нитей своего процесса (MPI_Reduce_local), затем
+ * одной операцией MPI_Exscan получает префикс предыдущих процессов и
+ * добавляет его к префиксам нитей. MPI вызывается только из главной нити,
+ * поэтому достаточно уровня поддержки MPI_THREAD_FUNNELED. Общие данные
+ * нитей заводятся на каждый вызов, поэтому одновременные и вложенные
+ * области не мешают друг другу.
+ * @tparam T: тип значения.
+ * @param from_value: исходное значение нити.
+ * @param to_value: значение нити, куда будет записан результат операции.
+ * @param datatype: тип данных значения (используется главной нитью).
+ * @param op: операция MPI (используется главной нитью).
+ * @param is_exclusive: исключать ли значение самой нити.
+ * @param comm: коммуникатор MPI.
+ */
+template <typename T>
+inline void HybridScanValue(const T &from_value, T &to_value,
+                            MPI_Datatype datatype, MPI_Op op,
+                            bool is_exclusive, MPI_Comm comm) {
+  // общие для нитей команды: значения нитей и префикс предыдущих процессов
+  struct Shared {
+    std::vector<T> thread_values;
+    T ranks_prefix;
+    bool has_ranks_prefix;
+  };
+
+  int thread = omp_get_thread_num(), threads_amount = omp_get_num_threads();
+
+#pragma omp master
+  {
+    int provided;
+    parallel::CheckSuccess(MPI_Query_thread(&provided));
+
+    if (threads_amount > 1 && provided < MPI_THREAD_FUNNELED)
+      parallel::Error(
+          "parallel::HybridScan: MPI should be initialized with "
+          "MPI_THREAD_FUNNELED or higher.");
+  }
+
+  // используются данные одной нити команды: указатель на них раздаётся
+  // остальным (copyprivate)
+  Shared thread_shared;
+  Shared *shared = &thread_shared;
+
+#pragma omp single copyprivate(shared)
+  shared->thread_values.resize(threads_amount);
+
+  std::vector<T> &thread_values = shared->thread_values;
+  T &ranks_prefix = shared->ranks_prefix;
+  bool &has_ranks_prefix = shared->has_ranks_prefix;
+
+  thread_values[thread] = from_value;
+
+#pragma omp barrier
+#pragma omp master
+  {
+    for (int i = 1; i < threads_amount; i++)
+      parallel::CheckSuccess(MPI_Reduce_local(
+          &thread_values[i - 1], &thread_values[i], 1, datatype, op));
+
+    T rank_total = thread_values[threads_amount - 1];
+
+    has_ranks_prefix = CurrRank(comm) != 0;
+    parallel::ScanArray(&rank_total, &ranks_prefix, 1, datatype, op, true,
+                        comm);
+
+    if (has_ranks_prefix)
+      for (int i = 0; i < threads_amount; i++)
+        parallel::CheckSuccess(MPI_Reduce_local(
+            &ranks_prefix, &thread_values[i], 1, datatype, op));
+  }
+#pragma omp barrier
+
+  if (!is_exclusive)
+    to_value = thread_values[thread];
+  else if (thread > 0)
+    to_value = thread_values[thread - 1];
+  else if (has_ranks_prefix)
+    to_value = ranks_prefix;
+
+  // общие данные лежат в стеке одной из нитей: она не выходит, пока
+  // остальные их читают
+#pragma omp barrier
+}
+
+/**
+ * @brief Выполняет операцию над значениями всех нитей OpenMP всех процессов
+ * до текущей нити включительно (включающий префикс).
+ * @details Нити упорядочены по (ранг процесса, номер нити). Вызывается
+ * всеми нитями параллельной области; см. parallel::HybridScanValue.
+ * @tparam T: тип значения.
+ * @param from_value: исходное значение нити.
+ * @param to_value: значение нити, куда будет записан результат операции.
+ * @param datatype: тип данных значения.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void HybridScan(const T &from_value, T &to_value,
+                       MPI_Datatype datatype, MPI_Op op,
+                       MPI_Comm comm = MPI_COMM_WORLD,
+                       bool need_print = false) {
+  if (need_print && omp_get_thread_num() == 0)
+    std::cout << "parallel::HybridScan with args: datatype: " << datatype
+              << "; op: " << op << "; comm: " << comm;
+
+  parallel::HybridScanValue(from_value, to_value, datatype, op, false, comm);
+
+  if (need_print && omp_get_thread_num() == 0)
+    std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Выполняет операцию над значениями всех нитей OpenMP всех процессов
+ * до текущей нити, не включая её (исключающий префикс).
+ * @details Нити упорядочены по (ранг процесса, номер нити). Так каждая нить
+ * одной коллективной операцией получает смещение своей части в глобальном
+ * массиве. У нулевой нити процесса ранга 0 to_value не изменяется.
+ * @tparam T: тип значения.
+ * @param from_value: исходное значение нити.
+ * @param to_value: значение нити, куда будет записан результат операции.
+ * @param datatype: тип данных значения.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void HybridExclusiveScan(const T &from_value, T &to_value,
+                                MPI_Datatype datatype, MPI_Op op,
+                                MPI_Comm comm = MPI_COMM_WORLD,
+                                bool need_print = false) {
+  if (need_print && omp_get_thread_num() == 0)
+    std::cout << "parallel::HybridExclusiveScan with args: datatype: "
+              << datatype << "; op: " << op << "; comm: " << comm;
+
+  parallel::HybridScanValue(from_value, to_value, datatype, op, true, comm);
+
+  if (need_print && omp_get_thread_num() == 0)
+    std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Включающий префикс по нитям OpenMP всех процессов (тип данных
+ * выводится из T).
+ * @tparam T: тип значения.
+ * @param from_value: исходное значение нити.
+ * @param to_value: значение нити, куда будет записан результат операции.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T,
+          typename = typename std::enable_if<is_mpi_type<T>::value>::type>
+inline void HybridScan(const T &from_value, T &to_value, MPI_Op op,
+                       MPI_Comm comm = MPI_COMM_WORLD,
+                       bool need_print = false) {
+  // тип структуры регистрируется вызовом MPI, поэтому только главной нитью
+  MPI_Datatype datatype = MPI_DATATYPE_NULL;
+
+#pragma omp master
+  datatype = mpi_type<T>::get();
+
+  parallel::HybridScan(from_value, to_value, datatype, op, comm, need_print);
+}
+
+/**
+ * @brief Исключающий префикс по нитям OpenMP всех процессов (тип данных
+ * выводится из T).
+ * @tparam T: тип значения.
+ * @param from_value: исходное значение нити.
+ * @param to_value: значение нити, куда будет записан результат операции.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T,
+          typename = typename std::enable_if<is_mpi_type<T>::value>::type>
+inline void HybridExclusiveScan(const T &from_value, T &to_value, MPI_Op op,
+                                MPI_Comm comm = MPI_COMM_WORLD,
+                                bool need_print = false) {
+  MPI_Datatype datatype = MPI_DATATYPE_NULL;
+
+#pragma omp master
+  datatype = mpi_type<T>::get();
+
+  parallel::HybridExclusiveScan(from_value, to_value, datatype, op, comm,
+                                need_print);
+}
+
+/**
+ * @brief Включающий префикс по нитям OpenMP всех процессов с операцией,
+ * заданной функтором C++ (см. parallel::Scan).
+ * @tparam T: тип значения.
+ * @tparam F: тип функтора T(const T& a, const T& b).
+ * @param from_value: исходное значение нити.
+ * @param to_value: значение нити, куда будет записан результат операции.
+ * @param functor: функтор операции.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T, typename F,
+          typename = typename std::enable_if<is_mpi_type<T>::value>::type>
+inline void HybridScan(const T &from_value, T &to_value, const F &functor,
+                       MPI_Comm comm = MPI_COMM_WORLD,
+                       bool need_print = false) {
+  MPI_Op op = MPI_OP_NULL;
+
+#pragma omp master
+  op = UserOperation<T>(functor, false);
+
+  parallel::HybridScan(from_value, to_value, op, comm, need_print);
+}
+
+/**
+ * @brief Исключающий префикс по нитям OpenMP всех процессов с операцией,
+ * заданной функтором C++ (см. parallel::Scan).
+ * @tparam T: тип значения.
+ * @tparam F: тип функтора T(const T& a, const T& b).
+ * @param from_value: исходное значение нити.
+ * @param to_value: значение нити, куда будет записан результат операции.
+ * @param functor: функтор операции.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T, typename F,
+          typename = typename std::enable_if<is_mpi_type<T>::value>::type>
+inline void HybridExclusiveScan(const T &from_value, T &to_value,
+                                const F &functor,
+                                MPI_Comm comm = MPI_COMM_WORLD,
+                                bool need_print = false) {
+  MPI_Op op = MPI_OP_NULL;
+
+#pragma omp master
+  op = UserOperation<T>(functor, false);
+
+  parallel::HybridExclusiveScan(from_value, to_value, op, comm, need_print);
+}
+#endif
+
+/**
+ * @brief Начинает неблокирующую операцию над значением с рассылкой
+ * результата всем процессам в сети MPI (MPI_Iallreduce).
+ * @tparam T: тип значения.
+ * @param from_value: исходное значение (должно жить до завершения операции).
+ * @param to_value: значение, куда будет записан результат операции.
+ * @param datatype: тип данных значения.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ * @return parallel::Request: дескриптор операции.
+ */
+template <typename T>
+inline Request IAllOperation(const T &from_value, T &to_value,
+                             MPI_Datatype datatype, MPI_Op op,
+                             MPI_Comm comm = MPI_COMM_WORLD,
+                             bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::IAllOperation with args: from_value: "
+              << from_value << "; to_value: " << to_value
+              << "; datatype: " << datatype << "; op: " << op
+              << "; comm: " << comm;
+
+  Request request;
+  parallel::CheckSuccess(MPI_Iallreduce(&from_value, &to_value, 1, datatype,
+                                        op, comm, &request.Handle()));
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+
+  return request;
+}
+
+/**
+ * @brief Начинает неблокирующую операцию над массивом значений с рассылкой
+ * результата всем процессам в сети MPI (MPI_Iallreduce).
+ * @details Если from_arr совпадает с to_arr, используется MPI_IN_PLACE.
+ * @tparam T: тип значения в массиве.
+ * @param from_arr: исходный массив значений (должен жить до завершения
+ * операции).
+ * @param to_arr: массив, куда будет записан результат операции.
+ * @param arr_len: количество элементов в массиве.
+ * @param datatype: тип данных элементов массива.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ * @return parallel::Request: дескриптор операции.
+ */
+template <typename T>
+inline Request IAllOperation(const T *from_arr, T *to_arr, int arr_len,
+                             MPI_Datatype datatype, MPI_Op op,
+                             MPI_Comm comm = MPI_COMM_WORLD,
+                             bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::IAllOperation with args: from_arr: " << from_arr
+              << "; to_arr: " << to_arr << "; arr_len: " << arr_len
+              << "; datatype: " << datatype << "; op: " << op
+              << "; comm: " << comm;
+
+  if (arr_len < 0)
+    parallel::Error(
+        "parallel::IAllOperation: arr_len should be non-negative.");
+
+  Request request;
+  parallel::CheckSuccess(
+      MPI_Iallreduce(from_arr == to_arr ? MPI_IN_PLACE : from_arr, to_arr,
+                     arr_len, datatype, op, comm, &request.Handle()));
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+
+  return request;
+}
+
+/**
+ * @brief Начинает неблокирующую операцию над вектором значений с рассылкой
+ * результата всем процессам в сети MPI (MPI_Iallreduce).
+ * @details Если from_vec и to_vec - один и тот же вектор, используется
+ * MPI_IN_PLACE.
+ * @tparam T: тип значения в векторе.
+ * @param from_vec: исходный вектор значений (должен жить до завершения
+ * операции).
+ * @param to_vec: вектор, куда будет записан результат операции.
+ * @param datatype: тип данных в векторе.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ * @return parallel::Request: дескриптор операции.
+ */
+template <typename T>
+inline Request IAllOperation(const std::vector<T> &from_vec,
+                             std::vector<T> &to_vec, MPI_Datatype datatype,
+                             MPI_Op op, MPI_Comm comm = MPI_COMM_WORLD,
+                             bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::IAllOperation with args: from_vec: " << from_vec
+              << "; to_vec: " << to_vec << "; datatype: " << datatype
+              << "; op: " << op << "; comm: " << comm;
+
+  std::size_t arr_len = Min(from_vec.size(), to_vec.size());
+
+  if (arr_len > INT_MAX)
+    parallel::Error(
+        "parallel::IAllOperation: vector is too big (size > INT_MAX).");
+
+  Request request =
+      parallel::IAllOperation(from_vec.data(), to_vec.data(),
+                              static_cast<int>(arr_len), datatype, op, comm);
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+
+  return request;
+}
+
+/**
+ * @brief Начинает неблокирующую операцию над значением с рассылкой
+ * результата всем процессам в сети MPI (тип данных выводится из T).
+ * @tparam T: тип значения.
+ * @param from_value: исходное значение (должно жить до завершения операции).
+ * @param to_value: значение, куда будет записан результат операции.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ * @return parallel::Request: дескриптор операции.
+ */
+template <typename T,
+          typename = typename std::enable_if<is_mpi_type<T>::value>::type>
+inline Request IAllOperation(const T &from_value, T &to_value, MPI_Op op,
+                             MPI_Comm comm = MPI_COMM_WORLD,
+                             bool need_print = false) {
+  return parallel::IAllOperation(&from_value, &to_value, 1, mpi_type<T>::get(),
+                                 op, comm, need_print);
+}
+
+/**
+ * @brief Начинает неблокирующую операцию над массивом значений с рассылкой
+ * результата всем процессам в сети MPI (тип данных выводится из T).
+ * @tparam T: тип значения в массиве.
+ * @param from_arr: исходный массив значений (должен жить до завершения
+ * операции).
+ * @param to_arr: массив, куда будет записан результат операции.
+ * @param arr_len: количество элементов в массиве.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ * @return parallel::Request: дескриптор операции.
+ */
+template <typename T>
+inline Request IAllOperation(const T *from_arr, T *to_arr, int arr_len,
+                             MPI_Op op, MPI_Comm comm = MPI_COMM_WORLD,
+                             bool need_print = false) {
+  return parallel::IAllOperation(from_arr, to_arr, arr_len, mpi_type<T>::get(),
+                                 op, comm, need_print);
+}
+
+/**
+ * @brief Начинает неблокирующую операцию над вектором значений с рассылкой
+ * результата всем процессам в сети MPI (тип данных выводится из T).
+ * @tparam T: тип значения в векторе.
+ * @param from_vec: исходный вектор значений (должен жить до завершения
+ * операции).
+ * @param to_vec: вектор, куда будет записан результат операции.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ * @return parallel::Request: дескриптор операции.
+ */
+template <typename T>
+inline Request IAllOperation(const std::vector<T> &from_vec,
+                             std::vector<T> &to_vec, MPI_Op op,
+                             MPI_Comm comm = MPI_COMM_WORLD,
+                             bool need_print = false) {
+  std::size_t arr_len = Min(from_vec.size(), to_vec.size());
+
+  if (arr_len > INT_MAX)
+    parallel::Error(
+        "parallel::IAllOperation: vector is too big (size > INT_MAX).");
+
+  return parallel::IAllOperation(from_vec.data(), to_vec.data(),
+                                 static_cast<int>(arr_len), mpi_type<T>::get(),
+                                 op, comm, need_print);
+}
+
+/**
+ * @brief Собирать значения от всех процессов в сети MPI в одном процессе.
+ * @tparam T: тип значения.
+ * @param from_value: значение, которое будет отправлено от текущего процесса.
+ * @param from_value_datatype: тип данных `from_value`.
+ * @param to_value: ссылка на значение, куда будет записан результат сбора на
+ * процессе `to_rank`.
+ * @param to_value_datatype: тип данных `to_value`.
+ * @param to_rank: ранг процесса результата. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void Gather(const T &from_value, MPI_Datatype from_value_datatype,
+                   T &to_value, MPI_Datatype to_value_datatype,
+                   unsigned int to_rank = 0, MPI_Comm comm = MPI_COMM_WORLD,
+                   bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::Gather with args: from_value: " << from_value
+              << "; from_value_datatype: " << from_value_datatype
+              << "; to_value: " << to_value
+              << "; to_value_datatype: " << to_value_datatype
+              << "; to_rank: " << to_rank << "; comm: " << comm;
+
+  parallel::CheckSuccess(MPI_Gather(&from_value, 1, from_value_datatype,
+                                    &to_value, 1, to_value_datatype, to_rank,
+                                    comm));
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Собирает массивы от всех процессов в сети MPI в одном процессе.
+ * @tparam T: тип значения в массиве.
+ * @param from_arr: массив, который будет отправлен от текущего процесса.
+ * @param from_arr_len: количество элементов в массиве `from_arr`.
+ * @param from_arr_datatype: тип данных элементов массива `from_arr`.
+ * @param to_arr: массив, куда будет записан результат сбора на процессе
+ * `to_rank`.
+ * @param to_arr_len: количество элементов в массиве `to_arr`.
+ * @param to_arr_datatype: тип данных элементов массива `to_arr`.
+ * @param to_rank: ранг процесса результата. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void Gather(const T *from_arr, int from_arr_len,
+                   MPI_Datatype from_arr_datatype, T *to_arr, int to_arr_len,
+                   MPI_Datatype to_arr_datatype, unsigned int to_rank = 0,
+                   MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::Gather with args: from_arr: " << from_arr_len
+              << "; from_arr_len: " << from_arr_len
+              << "; from_arr_datatype: " << from_arr_datatype
+              << "; to_arr: " << to_arr << "; to_arr_len: " << to_arr_len
+              << "; to_arr_datatype: " << to_arr_datatype
+              << "; to_rank: " << to_rank << "; comm: " << comm;
+
+  if (from_arr_len < 0 || to_arr_len < 0)
+    parallel::Error("parallel::Gather: arr_len should be non-negative.");
+
+  parallel::CheckSuccess(MPI_Gather(from_arr, from_arr_len, from_arr_datatype,
+                                    to_arr, to_arr_len, to_arr_datatype,
+                                    to_rank, comm));
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Собирает векторы одинакового размера от всех процессов в сети MPI в
+ * одном процессе.
+ * @details Способ сбора выбирается по размеру `from_vec`, одинаковому на
+ * всех процессах, поэтому все процессы входят в одну и ту же операцию.
+ * @tparam T: тип значения в векторе.
+ * @param from_vec: вектор, который будет отправлен от текущего процесса.
+ * @param from_vec_datatype: тип данных элементов вектора `from_arr`.
+ * @param to_vec: вектор, куда будет записан результат сбора на процессе
+ * `to_rank` (на нём при необходимости увеличивается до `from_vec.size()` *
+ * количество процессов).
+ * @param to_vec_datatype: тип данных элементов вектора `to_arr`.
+ * @param to_rank: ранг процесса результата. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void Gather(const std::vector<T> &from_vec,
+                   MPI_Datatype from_vec_datatype, std::vector<T> &to_vec,
+                   MPI_Datatype to_vec_datatype, unsigned int to_rank = 0,
+                   MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::Gather with args: from_vec: " << from_vec
+              << "; from_vec_datatype: " << from_vec_datatype
+              << "; to_vec: " << to_vec
+              << "; to_vec_datatype: " << to_vec_datatype
+              << "; to_rank: " << to_rank << "; comm: " << comm;
+
+  std::size_t to_vec_len = from_vec.size() * parallel::RanksAmount(comm);
+
+  if (parallel::CurrRank(comm) == static_cast<int>(to_rank) &&
+      to_vec.size() < to_vec_len)
+    to_vec.resize(to_vec_len);
+
+  if (from_vec.size() > PARALLEL_MAX_COUNT)
+    parallel::GatherLarge(from_vec.data(), from_vec.size(), from_vec_datatype,
+                          to_vec.data(), to_vec_datatype, to_rank, comm);
+  else
+    parallel::Gather(from_vec.data(), static_cast<int>(from_vec.size()),
+                     from_vec_datatype, to_vec.data(),
+                     static_cast<int>(from_vec.size()), to_vec_datatype,
+                     to_rank, comm);
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Собирает значения от всех процессов в сети MPI в одном процессе (тип
+ * данных выводится из T).
+ * @tparam T: тип значения.
+ * @param from_value: значение, которое будет отправлено от текущего процесса.
+ * @param to_value: ссылка на значение, куда будет записан результат сбора на
+ * процессе `to_rank`.
+ * @param to_rank: ранг процесса результата. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T,
+          typename = typename std::enable_if<is_mpi_type<T>::value>::type>
+inline void Gather(const T &from_value, T &to_value, unsigned int to_rank = 0,
+                   MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
+  parallel::Gather(&from_value, 1, mpi_type<T>::get(), &to_value, 1,
+                   mpi_type<T>::get(), to_rank, comm, need_print);
+}
+
+/**
+ * @brief Собирает массивы от всех процессов в сети MPI в одном процессе (тип
+ * данных выводится из T).
+ * @tparam T: тип значения в массиве.
+ * @param from_arr: массив, который будет отправлен от текущего процесса.
+ * @param from_arr_len: количество элементов в массиве `from_arr`.
+ * @param to_arr: массив, куда будет записан результат сбора на процессе
+ * `to_rank`.
+ * @param to_arr_len: количество элементов, получаемых от каждого процесса.
+ * @param to_rank: ранг процесса результата. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void Gather(const T *from_arr, int from_arr_len, T *to_arr,
+                   int to_arr_len, unsigned int to_rank = 0,
+                   MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
+  parallel::Gather(from_arr, from_arr_len, mpi_type<T>::get(), to_arr,
+                   to_arr_len, mpi_type<T>::get(), to_rank, comm, need_print);
+}
+
+/**
+ * @brief Собирает векторы одинакового размера от всех процессов в сети MPI в
+ * одном процессе (тип данных выводится из T).
+ * @tparam T: тип значения в векторе.
+ * @param from_vec: вектор, который будет отправлен от текущего процесса.
+ * @param to_vec: вектор, куда будет записан результат сбора на процессе
+ * `to_rank` (на нём при необходимости увеличивается до `from_vec.size()` *
+ * количество процессов).
+ * @param to_rank: ранг процесса результата. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void Gather(const std::vector<T> &from_vec, std::vector<T> &to_vec,
+                   unsigned int to_rank = 0, MPI_Comm comm = MPI_COMM_WORLD,
+                   bool need_print = false) {
+  parallel::Gather(from_vec, mpi_type<T>::get(), to_vec, mpi_type<T>::get(),
+                   to_rank, comm, need_print);
+}
+
+/**
+ * @brief Начинает неблокирующий сбор массивов от всех процессов в сети MPI в
+ * одном процессе (MPI_Igather).
+ * @tparam T: тип значения в массиве.
+ * @param from_arr: массив, который будет отправлен от текущего процесса
+ * (должен жить до завершения операции).
+ * @param from_arr_len: количество элементов в массиве `from_arr`.
+ * @param from_arr_datatype: тип данных элементов массива `from_arr`.
+ * @param to_arr: массив, куда будет записан результат сбора на процессе
+ * `to_rank`.
+ * @param to_arr_len: количество элементов, получаемых от каждого процесса.
+ * @param to_arr_datatype: тип данных элементов массива `to_arr`.
+ * @param to_rank: ранг процесса результата. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ * @return parallel::Request: дескриптор операции.
+ */
+template <typename T>
+inline Request IGather(const T *from_arr, int from_arr_len,
+                       MPI_Datatype from_arr_datatype, T *to_arr,
+                       int to_arr_len, MPI_Datatype to_arr_datatype,
+                       unsigned int to_rank = 0, MPI_Comm comm = MPI_COMM_WORLD,
+                       bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::IGather with args: from_arr: " << from_arr
+              << "; from_arr_len: " << from_arr_len
+              << "; from_arr_datatype: " << from_arr_datatype
+              << "; to_arr: " << to_arr << "; to_arr_len: " << to_arr_len
+              << "; to_arr_datatype: " << to_arr_datatype
+              << "; to_rank: " << to_rank << "; comm: " << comm;
+
+  if (from_arr_len < 0 || to_arr_len < 0)
+    parallel::Error("parallel::IGather: arr_len should be non-negative.");
+
+  Request request;
+  parallel::CheckSuccess(MPI_Igather(from_arr, from_arr_len, from_arr_datatype,
+                                     to_arr, to_arr_len, to_arr_datatype,
+                                     to_rank, comm, &request.Handle()));
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+
+  return request;
+}
+
+/**
+ * @brief Начинает неблокирующий сбор значений от всех процессов в сети MPI в
+ * одном процессе (тип данных выводится из T).
+ * @tparam T: тип значения.
+ * @param from_value: значение, которое будет отправлено от текущего процесса
+ * (должно жить до завершения операции).
+ * @param to_arr: массив, куда будет записан результат сбора на процессе
+ * `to_rank` (по одному значению от каждого процесса).
+ * @param to_rank: ранг процесса результата. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ * @return parallel::Request: дескриптор операции.
+ */
+template <typename T,
+          typename = typename std::enable_if<is_mpi_type<T>::value>::type>
+inline Request IGather(const T &from_value, T *to_arr, unsigned int to_rank = 0,
+                       MPI_Comm comm = MPI_COMM_WORLD,
+                       bool need_print = false) {
+  return parallel::IGather(&from_value, 1, mpi_type<T>::get(), to_arr, 1,
+                           mpi_type<T>::get(), to_rank, comm, need_print);
+}
+
+/**
+ * @brief Начинает неблокирующий сбор массивов от всех процессов в сети MPI в
+ * одном процессе (тип данных выводится из T).
+ * @tparam T: тип значения в массиве.
+ * @param from_arr: массив, который будет отправлен от текущего процесса
+ * (должен жить до завершения операции).
+ * @param from_arr_len: количество элементов в массиве `from_arr`.
+ * @param to_arr: массив, куда будет записан результат сбора на процессе
+ * `to_rank`.
+ * @param to_arr_len: количество элементов, получаемых от каждого процесса.
+ * @param to_rank: ранг процесса результата. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ * @return parallel::Request: дескриптор операции.
+ */
+template <typename T>
+inline Request IGather(const T *from_arr, int from_arr_len, T *to_arr,
+                       int to_arr_len, unsigned int to_rank = 0,
+                       MPI_Comm comm = MPI_COMM_WORLD,
+                       bool need_print = false) {
+  return parallel::IGather(from_arr, from_arr_len, mpi_type<T>::get(), to_arr,
+                           to_arr_len, mpi_type<T>::get(), to_rank, comm,
+                           need_print);
+}
+
+/**
+ * @brief Начинает неблокирующий сбор векторов одинакового размера от всех
+ * процессов в сети MPI в одном процессе (тип данных выводится из T).
+ * @tparam T: тип значения в векторе.
+ * @param from_vec: вектор, который будет отправлен от текущего процесса
+ * (должен жить до завершения операции).
+ * @param to_vec: вектор, куда будет записан результат сбора на процессе
+ * `to_rank` (размер не меньше `from_vec.size()` * количество процессов).
+ * @param to_rank: ранг процесса результата. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ * @return parallel::Request: дескриптор операции.
+ */
+template <typename T>
+inline Request IGather(const std::vector<T> &from_vec, std::vector<T> &to_vec,
+                       unsigned int to_rank = 0, MPI_Comm comm = MPI_COMM_WORLD,
+                       bool need_print = false) {
+  if (from_vec.size() > INT_MAX)
+    parallel::Error("parallel::IGather: vector is too big (size > INT_MAX).");
+
+  return parallel::IGather(from_vec.data(), static_cast<int>(from_vec.size()),
+                           to_vec.data(), static_cast<int>(from_vec.size()),
+                           to_rank, comm, need_print);
+}
+
+/**
+ * @brief Собирает массивы от всех процессов в сети MPI в одном процессе с
+ * различными размерами для каждого процесса.
+ * @tparam T: тип значения в массиве.
+ * @param from_arr: массив, который будет отправлен от текущего процесса.
+ * @param from_arr_datatype: тип данных элементов массива `from_arr`.
+ * @param to_arr: массив, куда будет записан результат сбора на процессе
+ * `to_rank`.
+ * @param to_arr_datatype: тип данных элементов массива `to_arr`.
+ * @param to_arr_counts: количество значений, которое будет получено от каждого
+ * процесса.
+ * @param displacements: смещения в массиве `to_arr` для каждого
+ * процесса.
+ * @param arr_len: количество элементов в массиве `from_arr` и `to_arr`.
+ * @param to_rank: ранг процесса результата. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void GatherVarious(const T *from_arr, MPI_Datatype from_arr_datatype,
+                          T *to_arr, MPI_Datatype to_arr_datatype,
+                          const int *to_arr_counts, const int *displacements,
+                          int arr_len, unsigned int to_rank = 0,
+                          MPI_Comm comm = MPI_COMM_WORLD,
+                          bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::GatherVarious with args: from_arr: " << from_arr
+              << "; from_arr_datatype: " << from_arr_datatype
+              << "; to_arr: " << to_arr
+              << "; to_arr_datatype: " << to_arr_datatype
+              << "; to_arr_counts: " << to_arr_counts
+              << "; displacements: " << displacements
+              << "; arr_len: " << arr_len << "; to_rank: " << to_rank
+              << "; comm: " << comm;
+
+  if (arr_len < 0)
+    parallel::Error("parallel::GatherVarious: arr_len should be non-negative.");
+
+  parallel::CheckSuccess(MPI_Gatherv(from_arr, arr_len, from_arr_datatype,
+                                     to_arr, to_arr_counts, displacements,
+                                     to_arr_datatype, to_rank, comm));
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Собирает векторы от всех процессов в сети MPI в одном процессе с
+ * различными размерами для каждого процесса.
+ * @tparam T: тип значения в векторе.
+ * @param from_vec: вектор, который будет отправлен от текущего процесса.
+ * @param from_vec_datatype: тип данных элементов вектора `from_arr`.
+ * @param to_vec: вектор, куда будет записан результат сбора на процессе
+ * `to_rank`.
+ * @param to_vec_datatype: тип данных элементов вектора `to_arr`.
+ * @param to_vec_counts: количество значений, которое будет получено от каждого
+ * процесса.
+ * @param displacements: смещения в векторе `to_vec` для каждого
+ * процесса.
+ * @param to_rank: ранг процесса результата. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void GatherVarious(const std::vector<T> &from_vec,
+                          MPI_Datatype from_vec_datatype,
+                          std::vector<T> &to_vec, MPI_Datatype to_vec_datatype,
+                          const std::vector<int> to_vec_counts,
+                          const std::vector<int> displacements,
+                          unsigned int to_rank = 0,
+                          MPI_Comm comm = MPI_COMM_WORLD,
+                          bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::GatherVarious with args: from_vec: " << from_vec
+              << "; from_vec_datatype: " << from_vec_datatype
+              << "; to_vec: " << to_vec
+              << "; to_vec_datatype: " << to_vec_datatype
+              << "; to_vec_counts: " << to_vec_counts
+              << "; displacements: " << displacements
+              << "; to_rank: " << to_rank << "; comm: " << comm;
+
+  // счётчики и смещения MPI_Gatherv имеют тип int, поэтому ограничен только
+  // размер отправляемой части, но не размер собранного вектора
+  std::size_t arr_len = Min(from_vec.size(), to_vec.size(),
+                            to_vec_counts.size(), displacements.size());
+
+  if (arr_len > INT_MAX)
+    parallel::Error(
+        "parallel::GatherVarious: vector is too big (size > INT_MAX).");
+
+  parallel::GatherVarious(from_vec.data(), from_vec_datatype, to_vec.data(),
+                          to_vec_datatype, to_vec_counts.data(),
+                          displacements.data(), static_cast<int>(arr_len),
+                          to_rank, comm);
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Собирает массивы от всех процессов в сети MPI в одном процессе с
+ * различными размерами для каждого процесса (тип данных выводится из T).
+ * @tparam T: тип значения в массиве.
+ * @param from_arr: массив, который будет отправлен от текущего процесса.
+ * @param to_arr: массив, куда будет записан результат сбора на процессе
+ * `to_rank`.
+ * @param to_arr_counts: количество значений, которое будет получено от каждого
+ * процесса.
+ * @param displacements: смещения в массиве `to_arr` для каждого
+ * процесса.
+ * @param arr_len: количество элементов в массиве `from_arr`.
+ * @param to_rank: ранг процесса результата. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void GatherVarious(const T *from_arr, T *to_arr,
+                          const int *to_arr_counts, const int *displacements,
+                          int arr_len, unsigned int to_rank = 0,
+                          MPI_Comm comm = MPI_COMM_WORLD,
+                          bool need_print = false) {
+  parallel::GatherVarious(from_arr, mpi_type<T>::get(), to_arr,
+                          mpi_type<T>::get(), to_arr_counts, displacements,
+                          arr_len, to_rank, comm, need_print);
+}
+
+/**
+ * @brief Собирает векторы от всех процессов в сети MPI в одном процессе с
+ * различными размерами для каждого процесса (тип данных выводится из T).
+ * @tparam T: тип значения в векторе.
+ * @param from_vec: вектор, который будет отправлен от текущего процесса
+ * (целиком).
+ * @param to_vec: вектор, куда будет записан результат сбора на процессе
+ * `to_rank`.
+ * @param to_vec_counts: количество значений, которое будет получено от каждого
+ * процесса.
+ * @param displacements: смещения в векторе `to_vec` для каждого
+ * процесса.
+ * @param to_rank: ранг процесса результата. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void GatherVarious(const std::vector<T> &from_vec,
+                          std::vector<T> &to_vec,
+                          const std::vector<int> &to_vec_counts,
+                          const std::vector<int> &displacements,
+                          unsigned int to_rank = 0,
+                          MPI_Comm comm = MPI_COMM_WORLD,
+                          bool need_print = false) {
+  if (from_vec.size() > INT_MAX)
+    parallel::Error(
+        "parallel::GatherVarious: vector is too big (size > INT_MAX).");
+
+  parallel::GatherVarious(from_vec.data(), to_vec.data(), to_vec_counts.data(),
+                          displacements.data(),
+                          static_cast<int>(from_vec.size()), to_rank, comm,
+                          need_print);
+}
+
+/**
+ * @brief Собирает длины частей для GatherConcat на процессе to_rank и
+ * вычисляет смещения частей (исключающая префиксная сумма).
+ * @param from_arr_len: длина части текущего процесса.
+ * @param to_counts: длины частей всех процессов на процессе `to_rank`
+ * (выходной параметр).
+ * @param to_displacements: смещения частей на процессе `to_rank` (выходной
+ * параметр).
+ * @param to_rank: ранг процесса результата.
+ * @param comm: коммуникатор MPI.
+ * @return std::size_t: общая длина на процессе `to_rank` (0 на остальных).
+ */
+inline std::size_t GatherConcatCounts(int from_arr_len, int *to_counts,
+                                      int *to_displacements,
+                                      unsigned int to_rank, MPI_Comm comm) {
+  parallel::CheckSuccess(MPI_Gather(&from_arr_len, 1, MPI_INT, to_counts, 1,
+                                    MPI_INT, to_rank, comm));
+
+  if (parallel::CurrRank(comm) != static_cast<int>(to_rank)) return 0;
+
+  // смещения MPI_Gatherv имеют тип int
+  long long total = 0;
+  for (int i = 0; i < parallel::RanksAmount(comm); i++) {
+    if (total + to_counts[i] > INT_MAX)
+      parallel::Error(
+          "parallel::GatherConcat: result is too big (size > INT_MAX).");
+
+    to_displacements[i] = static_cast<int>(total);
+    total += to_counts[i];
+  }
+
+  return static_cast<std::size_t>(total);
+}
+
+/**
+ * @brief Собирает части разной длины от всех процессов в сети MPI в один
+ * вектор на процессе to_rank и сообщает длины частей.
+ * @details Длины частей заранее не нужны: они собираются, смещения
+ * вычисляются, и результат выделяется внутри; смещения берутся из пула
+ * parallel::BufferPool.
+ * @tparam T: тип значения.
+ * @param from_arr: часть текущего процесса.
+ * @param from_arr_len: длина части текущего процесса.
+ * @param datatype: тип данных элементов.
+ * @param to_vec: вектор, куда будет записан результат сбора на процессе
+ * `to_rank` (размер устанавливается автоматически).
+ * @param to_counts: длины частей всех процессов на процессе `to_rank`
+ * (размер устанавливается автоматически).
+ * @param to_rank: ранг процесса результата. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void GatherConcat(const T *from_arr, int from_arr_len,
+                         MPI_Datatype datatype, std::vector<T> &to_vec,
+                         std::vector<int> &to_counts, unsigned int to_rank = 0,
+                         MPI_Comm comm = MPI_COMM_WORLD,
+                         bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::GatherConcat with args: from_arr: " << from_arr
+              << "; from_arr_len: " << from_arr_len
+              << "; datatype: " << datatype << "; to_rank: " << to_rank
+              << "; comm: " << comm;
+
+  if (from_arr_len < 0)
+    parallel::Error("parallel::GatherConcat: arr_len should be non-negative.");
+
+  bool is_root = parallel::CurrRank(comm) == static_cast<int>(to_rank);
+  int ranks_amount = is_root ? parallel::RanksAmount(comm) : 0;
+
+  if (is_root) to_counts.resize(ranks_amount);
+  PooledBuffer<int> to_displacements(ranks_amount);
+
+  std::size_t total = parallel::GatherConcatCounts(
+      from_arr_len, to_counts.data(), to_displacements.Data(), to_rank, comm);
+
+  if (is_root) to_vec.resize(total);
+
+  parallel::CheckSuccess(MPI_Gatherv(
+      from_arr, from_arr_len, datatype, to_vec.data(), to_counts.data(),
+      to_displacements.Data(), datatype, to_rank, comm));
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Собирает части разной длины от всех процессов в сети MPI в один
+ * вектор на процессе to_rank (по порядку рангов).
+ * @details Длины частей заранее не нужны: они собираются, смещения
+ * вычисляются, и результат выделяется внутри.
+ * @tparam T: тип значения.
+ * @param from_arr: часть текущего процесса.
+ * @param from_arr_len: длина части текущего процесса.
+ * @param datatype: тип данных элементов.
+ * @param to_vec: вектор, куда будет записан результат сбора на процессе
+ * `to_rank` (размер устанавливается автоматически).
+ * @param to_rank: ранг процесса результата. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void GatherConcat(const T *from_arr, int from_arr_len,
+                         MPI_Datatype datatype, std::vector<T> &to_vec,
+                         unsigned int to_rank = 0,
+                         MPI_Comm comm = MPI_COMM_WORLD,
+                         bool need_print = false) {
+  std::vector<int> to_counts;
+
+  parallel::GatherConcat(from_arr, from_arr_len, datatype, to_vec, to_counts,
+                         to_rank, comm, need_print);
+}
+
+/**
+ * @brief Собирает части разной длины от всех процессов в сети MPI в один
+ * вектор на процессе to_rank (тип данных выводится из T).
+ * @tparam T: тип значения.
+ * @param from_arr: часть текущего процесса.
+ * @param from_arr_len: длина части текущего процесса.
+ * @param to_vec: вектор, куда будет записан результат сбора на процессе
+ * `to_rank` (размер устанавливается автоматически).
+ * @param to_rank: ранг процесса результата. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void GatherConcat(const T *from_arr, int from_arr_len,
+                         std::vector<T> &to_vec, unsigned int to_rank = 0,
+                         MPI_Comm comm = MPI_COMM_WORLD,
+                         bool need_print = false) {
+  parallel::GatherConcat(from_arr, from_arr_len, mpi_type<T>::get(), to_vec,
+                         to_rank, comm, need_print);
+}
+
+/**
+ * @brief Собирает векторы разной длины от всех процессов в сети MPI в один
+ * вектор на процессе to_rank (тип данных выводится из T).
+ * @tparam T: тип значения.
+ * @param from_vec: вектор текущего процесса.
+ * @param to_vec: вектор, куда будет записан результат сбора на процессе
+ * `to_rank` (размер устанавливается автоматически).
+ * @param to_rank: ранг процесса результата. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void GatherConcat(const std::vector<T> &from_vec, std::vector<T> &to_vec,
+                         unsigned int to_rank = 0,
+                         MPI_Comm comm = MPI_COMM_WORLD,
+                         bool need_print = false) {
+  if (from_vec.size() > INT_MAX)
+    parallel::Error(
+        "parallel::GatherConcat: vector is too big (size > INT_MAX).");
+
+  parallel::GatherConcat(from_vec.data(), static_cast<int>(from_vec.size()),
+                         mpi_type<T>::get(), to_vec, to_rank, comm,
+                         need_print);
+}
+
+/**
+ * @brief Собирает векторы разной длины от всех процессов в сети MPI в один
+ * вектор на процессе to_rank и сообщает их длины (тип данных выводится из
+ * T).
+ * @tparam T: тип значения.
+ * @param from_vec: вектор текущего процесса.
+ * @param to_vec: вектор, куда будет записан результат сбора на процессе
+ * `to_rank` (размер устанавливается автоматически).
+ * @param to_counts: длины векторов всех процессов на процессе `to_rank`
+ * (размер устанавливается автоматически).
+ * @param to_rank: ранг процесса результата. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void GatherConcat(const std::vector<T> &from_vec, std::vector<T> &to_vec,
+                         std::vector<int> &to_counts, unsigned int to_rank = 0,
+                         MPI_Comm comm = MPI_COMM_WORLD,
+                         bool need_print = false) {
+  if (from_vec.size() > INT_MAX)
+    parallel::Error(
+        "parallel::GatherConcat: vector is too big (size > INT_MAX).");
+
+  parallel::GatherConcat(from_vec.data(), static_cast<int>(from_vec.size()),
+                         mpi_type<T>::get(), to_vec, to_counts, to_rank, comm,
+                         need_print);
+}
+
+/**
+ * @brief Вычисляет границы части index при равномерном разбиении total
+ * элементов на parts частей.
+ * @details Первые total % parts частей получают на один элемент больше,
+ * поэтому размеры частей отличаются не более чем на 1 и остаток не теряется.
+ * @param total: общее количество элементов.
+ * @param parts: количество частей.
+ * @param index: номер части (от 0 до parts - 1).
+ * @param begin: начало части (выходной параметр).
+ * @param end: конец части, не включая (выходной параметр).
+ */
+inline void BalancedRange(int total, int parts, int index, int &begin,
+                          int &end) {
+  if (total < 0 || parts <= 0 || index < 0 || index >= parts)
+    parallel::Error("parallel::BalancedRange: invalid partition arguments.");
+
+  int base = total / parts;
+  int remainder = total % parts;
+
+  begin = index * base + Min(index, remainder);
+  end = begin + base + (index < remainder ? 1 : 0);
+}
+
+/**
+ * @brief Вычисляет количества и смещения частей при равномерном разбиении
+ * total элементов на parts частей (для ScatterVarious и GatherVarious).
+ * @param total: общее количество элементов.
+ * @param parts: количество частей.
+ * @param counts: количества элементов в частях (выходной параметр).
+ * @param displacements: смещения частей (выходной параметр).
+ */
+inline void BalancedPartition(int total, int parts, std::vector<int> &counts,
+                              std::vector<int> &displacements) {
+  if (total < 0 || parts <= 0)
+    parallel::Error(
+        "parallel::BalancedPartition: invalid partition arguments.");
+
+  counts.resize(parts);
+  displacements.resize(parts);
+
+  for (int i = 0; i < parts; i++) {
+    int end;
+    parallel::BalancedRange(total, parts, i, displacements[i], end);
+    counts[i] = end - displacements[i];
+  }
+}
+
+/**
+ * @brief Рассылает части массива одного процесса всем процессам в сети MPI.
+ * @tparam T: тип значения в массиве.
+ * @param from_arr: массив, части которого будут разосланы с процесса
+ * `from_rank`.
+ * @param from_arr_len: количество элементов, отправляемых каждому процессу.
+ * @param from_arr_datatype: тип данных элементов массива `from_arr`.
+ * @param to_arr: массив, куда будет записана часть текущего процесса.
+ * @param to_arr_len: количество элементов в массиве `to_arr`.
+ * @param to_arr_datatype: тип данных элементов массива `to_arr`.
+ * @param from_rank: ранг процесса, который рассылает массив. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void Scatter(const T *from_arr, int from_arr_len,
+                    MPI_Datatype from_arr_datatype, T *to_arr, int to_arr_len,
+                    MPI_Datatype to_arr_datatype, unsigned int from_rank = 0,
+                    MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::Scatter with args: from_arr: " << from_arr
+              << "; from_arr_len: " << from_arr_len
+              << "; from_arr_datatype: " << from_arr_datatype
+              << "; to_arr: " << to_arr << "; to_arr_len: " << to_arr_len
+              << "; to_arr_datatype: " << to_arr_datatype
+              << "; from_rank: " << from_rank << "; comm: " << comm;
+
+  if (from_arr_len < 0 || to_arr_len < 0)
+    parallel::Error("parallel::Scatter: arr_len should be non-negative.");
+
+  parallel::CheckSuccess(MPI_Scatter(from_arr, from_arr_len, from_arr_datatype,
+                                     to_arr, to_arr_len, to_arr_datatype,
+                                     from_rank, comm));
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Рассылает части вектора одного процесса всем процессам в сети MPI.
+ * @tparam T: тип значения в векторе.
+ * @param from_vec: вектор, части которого будут разосланы с процесса
+ * `from_rank` (каждому процессу по `to_vec.size()` элементов).
+ * @param from_vec_datatype: тип данных элементов вектора `from_vec`.
+ * @param to_vec: вектор, куда будет записана часть текущего процесса.
+ * @param to_vec_datatype: тип данных элементов вектора `to_vec`.
+ * @param from_rank: ранг процесса, который рассылает вектор. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void Scatter(const std::vector<T> &from_vec,
+                    MPI_Datatype from_vec_datatype, std::vector<T> &to_vec,
+                    MPI_Datatype to_vec_datatype, unsigned int from_rank = 0,
+                    MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::Scatter with args: from_vec: " << from_vec
+              << "; from_vec_datatype: " << from_vec_datatype
+              << "; to_vec: " << to_vec
+              << "; to_vec_datatype: " << to_vec_datatype
+              << "; from_rank: " << from_rank << "; comm: " << comm;
+
+  if (to_vec.size() > INT_MAX)
+    parallel::Error("parallel::Scatter: vector is too big (size > INT_MAX).");
+
+  parallel::Scatter(from_vec.data(), static_cast<int>(to_vec.size()),
+                    from_vec_datatype, to_vec.data(),
+                    static_cast<int>(to_vec.size()), to_vec_datatype,
+                    from_rank, comm);
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Рассылает по одному значению массива одного процесса всем процессам
+ * в сети MPI (тип данных выводится из T).
+ * @tparam T: тип значения.
+ * @param from_arr: массив (по значению на процесс), который рассылается с
+ * процесса `from_rank`.
+ * @param to_value: значение, куда будет записана часть текущего процесса.
+ * @param from_rank: ранг процесса, который рассылает массив. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T,
+          typename = typename std::enable_if<is_mpi_type<T>::value>::type>
+inline void Scatter(const T *from_arr, T &to_value, unsigned int from_rank = 0,
+                    MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
+  parallel::Scatter(from_arr, 1, mpi_type<T>::get(), &to_value, 1,
+                    mpi_type<T>::get(), from_rank, comm, need_print);
+}
+
+/**
+ * @brief Рассылает части массива одного процесса всем процессам в сети MPI
+ * (тип данных выводится из T).
+ * @tparam T: тип значения в массиве.
+ * @param from_arr: массив, части которого будут разосланы с процесса
+ * `from_rank`.
+ * @param to_arr: массив, куда будет записана часть текущего процесса.
+ * @param arr_len: количество элементов в части каждого процесса.
+ * @param from_rank: ранг процесса, который рассылает массив. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void Scatter(const T *from_arr, T *to_arr, int arr_len,
+                    unsigned int from_rank = 0, MPI_Comm comm = MPI_COMM_WORLD,
+                    bool need_print = false) {
+  parallel::Scatter(from_arr, arr_len, mpi_type<T>::get(), to_arr, arr_len,
+                    mpi_type<T>::get(), from_rank, comm, need_print);
+}
+
+/**
+ * @brief Рассылает части вектора одного процесса всем процессам в сети MPI
+ * (тип данных выводится из T).
+ * @tparam T: тип значения в векторе.
+ * @param from_vec: вектор, части которого будут разосланы с процесса
+ * `from_rank` (каждому процессу по `to_vec.size()` элементов).
+ * @param to_vec: вектор, куда будет записана часть текущего процесса.
+ * @param from_rank: ранг процесса, который рассылает вектор. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void Scatter(const std::vector<T> &from_vec, std::vector<T> &to_vec,
+                    unsigned int from_rank = 0, MPI_Comm comm = MPI_COMM_WORLD,
+                    bool need_print = false) {
+  if (to_vec.size() > INT_MAX)
+    parallel::Error("parallel::Scatter: vector is too big (size > INT_MAX).");
+
+  parallel::Scatter(from_vec.data(), to_vec.data(),
+                    static_cast<int>(to_vec.size()), from_rank, comm,
+                    need_print);
+}
+
+/**
+ * @brief Рассылает части массива одного процесса всем процессам в сети MPI с
+ * различными размерами для каждого процесса.
+ * @tparam T: тип значения в массиве.
+ * @param from_arr: массив, части которого будут разосланы с процесса
+ * `from_rank`.
+ * @param from_arr_datatype: тип данных элементов массива `from_arr`.
+ * @param to_arr: массив, куда будет записана часть текущего процесса.
+ * @param to_arr_datatype: тип данных элементов массива `to_arr`.
+ * @param from_arr_counts: количество значений, которое будет отправлено
+ * каждому процессу.
+ * @param displacements: смещения в массиве `from_arr` для каждого
+ * процесса.
+ * @param arr_len: количество элементов в массиве `to_arr`.
+ * @param from_rank: ранг процесса, который рассылает массив. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void ScatterVarious(const T *from_arr, MPI_Datatype from_arr_datatype,
+                           T *to_arr, MPI_Datatype to_arr_datatype,
+                           const int *from_arr_counts,
+                           const int *displacements, int arr_len,
+                           unsigned int from_rank = 0,
+                           MPI_Comm comm = MPI_COMM_WORLD,
+                           bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::ScatterVarious with args: from_arr: " << from_arr
+              << "; from_arr_datatype: " << from_arr_datatype
+              << "; to_arr: " << to_arr
+              << "; to_arr_datatype: " << to_arr_datatype
+              << "; from_arr_counts: " << from_arr_counts
+              << "; displacements: " << displacements
+              << "; arr_len: " << arr_len << "; from_rank: " << from_rank
+              << "; comm: " << comm;
+
+  if (arr_len < 0)
+    parallel::Error(
+        "parallel::ScatterVarious: arr_len should be non-negative.");
+
+  parallel::CheckSuccess(MPI_Scatterv(from_arr, from_arr_counts, displacements,
+                                      from_arr_datatype, to_arr, arr_len,
+                                      to_arr_datatype, from_rank, comm));
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Рассылает части массива одного процесса всем процессам в сети MPI с
+ * различными размерами для каждого процесса (тип данных выводится из T).
+ * @tparam T: тип значения в массиве.
+ * @param from_arr: массив, части которого будут разосланы с процесса
+ * `from_rank`.
+ * @param to_arr: массив, куда будет записана часть текущего процесса.
+ * @param from_arr_counts: количество значений, которое будет отправлено
+ * каждому процессу.
+ * @param displacements: смещения в массиве `from_arr` для каждого
+ * процесса.
+ * @param arr_len: количество элементов в массиве `to_arr`.
+ * @param from_rank: ранг процесса, который рассылает массив. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void ScatterVarious(const T *from_arr, T *to_arr,
+                           const int *from_arr_counts,
+                           const int *displacements, int arr_len,
+                           unsigned int from_rank = 0,
+                           MPI_Comm comm = MPI_COMM_WORLD,
+                           bool need_print = false) {
+  parallel::ScatterVarious(from_arr, mpi_type<T>::get(), to_arr,
+                           mpi_type<T>::get(), from_arr_counts, displacements,
+                           arr_len, from_rank, comm, need_print);
+}
+
+/**
+ * @brief Рассылает части вектора одного процесса всем процессам в сети MPI с
+ * различными размерами для каждого процесса (тип данных выводится из T).
+ * @tparam T: тип значения в векторе.
+ * @param from_vec: вектор, части которого будут разосланы с процесса
+ * `from_rank`.
+ * @param to_vec: вектор, куда будет записана часть текущего процесса
+ * (целиком).
+ * @param from_vec_counts: количество значений, которое будет отправлено
+ * каждому процессу.
+ * @param displacements: смещения в векторе `from_vec` для каждого
+ * процесса.
+ * @param from_rank: ранг процесса, который рассылает вектор. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void ScatterVarious(const std::vector<T> &from_vec,
+                           std::vector<T> &to_vec,
+                           const std::vector<int> &from_vec_counts,
+                           const std::vector<int> &displacements,
+                           unsigned int from_rank = 0,
+                           MPI_Comm comm = MPI_COMM_WORLD,
+                           bool need_print = false) {
+  if (to_vec.size() > INT_MAX)
+    parallel::Error(
+        "parallel::ScatterVarious: vector is too big (size > INT_MAX).");
+
+  parallel::ScatterVarious(from_vec.data(), to_vec.data(),
+                           from_vec_counts.data(), displacements.data(),
+                           static_cast<int>(to_vec.size()), from_rank, comm,
+                           need_print);
+}
+
+/**
+ * @brief Равномерно разбивает вектор одного процесса на части и рассылает их
+ * всем процессам в сети MPI (тип данных выводится из T).
+ * @details Разбиение строится parallel::BalancedPartition, размер `to_vec`
+ * устанавливается равным размеру части текущего процесса.
+ * @tparam T: тип значения в векторе.
+ * @param from_vec: вектор из `total` элементов на процессе `from_rank`.
+ * @param to_vec: вектор, куда будет записана часть текущего процесса.
+ * @param total: общее количество элементов (одинаковое на всех процессах).
+ * @param from_rank: ранг процесса, который рассылает вектор. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void ScatterBalanced(const std::vector<T> &from_vec,
+                            std::vector<T> &to_vec, int total,
+                            unsigned int from_rank = 0,
+                            MPI_Comm comm = MPI_COMM_WORLD,
+                            bool need_print = false) {
+  std::vector<int> counts, displacements;
+  parallel::BalancedPartition(total, parallel::RanksAmount(comm), counts,
+                              displacements);
+
+  to_vec.resize(counts[parallel::CurrRank(comm)]);
+
+  parallel::ScatterVarious(from_vec, to_vec, counts, displacements, from_rank,
+                           comm, need_print);
+}
+
+/**
+ * @brief Собирает массивы от всех процессов в сети MPI на всех процессах
+ * (MPI_Allgather).
+ * @tparam T: тип значения в массиве.
+ * @param from_arr: массив, который будет отправлен от текущего процесса.
+ * @param from_arr_len: количество элементов в массиве `from_arr`.
+ * @param from_arr_datatype: тип данных элементов массива `from_arr`.
+ * @param to_arr: массив, куда будет записан результат сбора.
+ * @param to_arr_len: количество элементов, получаемых от каждого процесса.
+ * @param to_arr_datatype: тип данных элементов массива `to_arr`.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void AllGather(const T *from_arr, int from_arr_len,
+                      MPI_Datatype from_arr_datatype, T *to_arr,
+                      int to_arr_len, MPI_Datatype to_arr_datatype,
+                      MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::AllGather with args: from_arr: " << from_arr
+              << "; from_arr_len: " << from_arr_len
+              << "; from_arr_datatype: " << from_arr_datatype
+              << "; to_arr: " << to_arr << "; to_arr_len: " << to_arr_len
+              << "; to_arr_datatype: " << to_arr_datatype
+              << "; comm: " << comm;
+
+  if (from_arr_len < 0 || to_arr_len < 0)
+    parallel::Error("parallel::AllGather: arr_len should be non-negative.");
+
+  parallel::CheckSuccess(MPI_Allgather(from_arr, from_arr_len,
+                                       from_arr_datatype, to_arr, to_arr_len,
+                                       to_arr_datatype, comm));
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Собирает векторы одинакового размера от всех процессов в сети MPI
+ * на всех процессах.
+ * @tparam T: тип значения в векторе.
+ * @param from_vec: вектор, который будет отправлен от текущего процесса.
+ * @param from_vec_datatype: тип данных элементов вектора `from_vec`.
+ * @param to_vec: вектор, куда будет записан результат сбора (размер
+ * устанавливается равным `from_vec.size()` * количество процессов).
+ * @param to_vec_datatype: тип данных элементов вектора `to_vec`.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void AllGather(const std::vector<T> &from_vec,
+                      MPI_Datatype from_vec_datatype, std::vector<T> &to_vec,
+                      MPI_Datatype to_vec_datatype,
+                      MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::AllGather with args: from_vec: " << from_vec
+              << "; from_vec_datatype: " << from_vec_datatype
+              << "; to_vec_datatype: " << to_vec_datatype
+              << "; comm: " << comm;
+
+  if (from_vec.size() > INT_MAX)
+    parallel::Error("parallel::AllGather: vector is too big (size > INT_MAX).");
+
+  to_vec.resize(from_vec.size() * parallel::RanksAmount(comm));
+
+  parallel::AllGather(from_vec.data(), static_cast<int>(from_vec.size()),
+                      from_vec_datatype, to_vec.data(),
+                      static_cast<int>(from_vec.size()), to_vec_datatype,
+                      comm);
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Собирает значения от всех процессов в сети MPI на всех процессах
+ * (тип данных выводится из T).
+ * @tparam T: тип значения.
+ * @param from_value: значение, которое будет отправлено от текущего процесса.
+ * @param to_arr: массив, куда будет записан результат сбора (по одному
+ * значению от каждого процесса).
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T,
+          typename = typename std::enable_if<is_mpi_type<T>::value>::type>
+inline void AllGather(const T &from_value, T *to_arr,
+                      MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
+  parallel::AllGather(&from_value, 1, mpi_type<T>::get(), to_arr, 1,
+                      mpi_type<T>::get(), comm, need_print);
+}
+
+/**
+ * @brief Собирает массивы от всех процессов в сети MPI на всех процессах (тип
+ * данных выводится из T).
+ * @tparam T: тип значения в массиве.
+ * @param from_arr: массив, который будет отправлен от текущего процесса.
+ * @param arr_len: количество элементов в массиве `from_arr`.
+ * @param to_arr: массив, куда будет записан результат сбора (`arr_len`
+ * элементов от каждого процесса).
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void AllGather(const T *from_arr, int arr_len, T *to_arr,
+                      MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
+  parallel::AllGather(from_arr, arr_len, mpi_type<T>::get(), to_arr, arr_len,
+                      mpi_type<T>::get(), comm, need_print);
+}
+
+/**
+ * @brief Собирает векторы одинакового размера от всех процессов в сети MPI
+ * на всех процессах (тип данных выводится из T).
+ * @tparam T: тип значения в векторе.
+ * @param from_vec: вектор, который будет отправлен от текущего процесса.
+ * @param to_vec: вектор, куда будет записан результат сбора (размер
+ * устанавливается равным `from_vec.size()` * количество процессов).
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void AllGather(const std::vector<T> &from_vec, std::vector<T> &to_vec,
+                      MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
+  if (from_vec.size() > INT_MAX)
+    parallel::Error("parallel::AllGather: vector is too big (size > INT_MAX).");
+
+  to_vec.resize(from_vec.size() * parallel::RanksAmount(comm));
+
+  parallel::AllGather(from_vec.data(), static_cast<int>(from_vec.size()),
+                      to_vec.data(), comm, need_print);
+}
+
+/**
+ * @brief Собирает массивы от всех процессов в сети MPI на всех процессах с
+ * различными размерами для каждого процесса (MPI_Allgatherv).
+ * @tparam T: тип значения в массиве.
+ * @param from_arr: массив, который будет отправлен от текущего процесса.
+ * @param from_arr_datatype: тип данных элементов массива `from_arr`.
+ * @param to_arr: массив, куда будет записан результат сбора.
+ * @param to_arr_datatype: тип данных элементов массива `to_arr`.
+ * @param to_arr_counts: количество значений, которое будет получено от каждого
+ * процесса.
+ * @param displacements: смещения в массиве `to_arr` для каждого
+ * процесса.
+ * @param arr_len: количество элементов в массиве `from_arr`.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void AllGatherVarious(const T *from_arr, MPI_Datatype from_arr_datatype,
+                             T *to_arr, MPI_Datatype to_arr_datatype,
+                             const int *to_arr_counts,
+                             const int *displacements, int arr_len,
+                             MPI_Comm comm = MPI_COMM_WORLD,
+                             bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::AllGatherVarious with args: from_arr: "
+              << from_arr << "; from_arr_datatype: " << from_arr_datatype
+              << "; to_arr: " << to_arr
+              << "; to_arr_datatype: " << to_arr_datatype
+              << "; to_arr_counts: " << to_arr_counts
+              << "; displacements: " << displacements
+              << "; arr_len: " << arr_len << "; comm: " << comm;
+
+  if (arr_len < 0)
+    parallel::Error(
+        "parallel::AllGatherVarious: arr_len should be non-negative.");
+
+  parallel::CheckSuccess(MPI_Allgatherv(from_arr, arr_len, from_arr_datatype,
+                                        to_arr, to_arr_counts, displacements,
+                                        to_arr_datatype, comm));
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Собирает массивы от всех процессов в сети MPI на всех процессах с
+ * различными размерами для каждого процесса (тип данных выводится из T).
+ * @tparam T: тип значения в массиве.
+ * @param from_arr: массив, который будет отправлен от текущего процесса.
+ * @param to_arr: массив, куда будет записан результат сбора.
+ * @param to_arr_counts: количество значений, которое будет получено от каждого
+ * процесса.
+ * @param displacements: смещения в массиве `to_arr` для каждого
+ * процесса.
+ * @param arr_len: количество элементов в массиве `from_arr`.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void AllGatherVarious(const T *from_arr, T *to_arr,
+                             const int *to_arr_counts,
+                             const int *displacements, int arr_len,
+                             MPI_Comm comm = MPI_COMM_WORLD,
+                             bool need_print = false) {
+  parallel::AllGatherVarious(from_arr, mpi_type<T>::get(), to_arr,
+                             mpi_type<T>::get(), to_arr_counts, displacements,
+                             arr_len, comm, need_print);
+}
+
+/**
+ * @brief Собирает векторы произвольного размера от всех процессов в сети MPI
+ * на всех процессах в порядке рангов (тип данных выводится из T).
+ * @details Процессы сначала обмениваются размерами своих векторов, затем
+ * смещения вычисляются на месте, поэтому передавать их не нужно. Служебные
+ * массивы берутся из parallel::BufferPool.
+ * @tparam T: тип значения в векторе.
+ * @param from_vec: вектор, который будет отправлен от текущего процесса.
+ * @param to_vec: вектор, куда будет записан результат сбора (размер
+ * устанавливается равным сумме размеров векторов всех процессов).
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void AllGatherVarious(const std::vector<T> &from_vec,
+                             std::vector<T> &to_vec,
+                             MPI_Comm comm = MPI_COMM_WORLD,
+                             bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::AllGatherVarious with args: from_vec: "
+              << from_vec.data() << "; from_vec_size: " << from_vec.size()
+              << "; comm: " << comm << "; ";
+
+  if (from_vec.size() > INT_MAX)
+    parallel::Error(
+        "parallel::AllGatherVarious: vector is too big (size > INT_MAX).");
+
+  int ranks_amount = parallel::RanksAmount(comm);
+
+  PooledBuffer<int> counts(ranks_amount);
+  PooledBuffer<int> displacements(ranks_amount);
+
+  int arr_len = static_cast<int>(from_vec.size());
+  parallel::AllGather(&arr_len, 1, MPI_INT, counts.Data(), 1, MPI_INT, comm);
+
+  // смещения MPI_Allgatherv имеют тип int, поэтому ограничен весь результат
+  long long total = 0;
+  for (int i = 0; i < ranks_amount; i++) {
+    if (total + counts[i] > INT_MAX)
+      parallel::Error(
+          "parallel::AllGatherVarious: result is too big (size > INT_MAX).");
+
+    displacements[i] = static_cast<int>(total);
+    total += counts[i];
+  }
+
+  to_vec.resize(static_cast<std::size_t>(total));
+
+  parallel::AllGatherVarious(from_vec.data(), to_vec.data(), counts.Data(),
+                             displacements.Data(), arr_len, comm);
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Каждый процесс в сети MPI отправляет каждому процессу свою часть
+ * массива (MPI_Alltoall).
+ * @tparam T: тип значения в массиве.
+ * @param from_arr: массив, i-я часть которого отправляется процессу i.
+ * @param from_arr_len: количество элементов в части, отправляемой каждому
+ * процессу.
+ * @param from_arr_datatype: тип данных элементов массива `from_arr`.
+ * @param to_arr: массив, i-я часть которого получается от процесса i.
+ * @param to_arr_len: количество элементов, получаемых от каждого процесса.
+ * @param to_arr_datatype: тип данных элементов массива `to_arr`.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void AllToAll(const T *from_arr, int from_arr_len,
+                     MPI_Datatype from_arr_datatype, T *to_arr, int to_arr_len,
+                     MPI_Datatype to_arr_datatype,
+                     MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::AllToAll with args: from_arr: " << from_arr
+              << "; from_arr_len: " << from_arr_len
+              << "; from_arr_datatype: " << from_arr_datatype
+              << "; to_arr: " << to_arr << "; to_arr_len: " << to_arr_len
+              << "; to_arr_datatype: " << to_arr_datatype
+              << "; comm: " << comm;
+
+  if (from_arr_len < 0 || to_arr_len < 0)
+    parallel::Error("parallel::AllToAll: arr_len should be non-negative.");
+
+  parallel::CheckSuccess(MPI_Alltoall(from_arr, from_arr_len, from_arr_datatype,
+                                      to_arr, to_arr_len, to_arr_datatype,
+                                      comm));
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Каждый процесс в сети MPI отправляет каждому процессу равную часть
+ * вектора (MPI_Alltoall).
+ * @tparam T: тип значения в векторе.
+ * @param from_vec: вектор, i-я часть которого отправляется процессу i
+ * (размер кратен количеству процессов).
+ * @param from_vec_datatype: тип данных элементов вектора `from_vec`.
+ * @param to_vec: вектор, i-я часть которого получается от процесса i (размер
+ * устанавливается равным `from_vec.size()`).
+ * @param to_vec_datatype: тип данных элементов вектора `to_vec`.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void AllToAll(const std::vector<T> &from_vec,
+                     MPI_Datatype from_vec_datatype, std::vector<T> &to_vec,
+                     MPI_Datatype to_vec_datatype,
+                     MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::AllToAll with args: from_vec: " << from_vec
+              << "; from_vec_datatype: " << from_vec_datatype
+              << "; to_vec_datatype: " << to_vec_datatype
+              << "; comm: " << comm;
+
+  std::size_t ranks_amount = parallel::RanksAmount(comm);
+
+  if (from_vec.size() % ranks_amount != 0)
+    parallel::Error(
+        "parallel::AllToAll: vector size should be a multiple of ranks "
+        "amount.");
+
+  if (from_vec.size() / ranks_amount > INT_MAX)
+    parallel::Error("parallel::AllToAll: vector is too big (size > INT_MAX).");
+
+  int arr_len = static_cast<int>(from_vec.size() / ranks_amount);
+  to_vec.resize(from_vec.size());
+
+  parallel::AllToAll(from_vec.data(), arr_len, from_vec_datatype,
+                     to_vec.data(), arr_len, to_vec_datatype, comm);
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Каждый процесс в сети MPI отправляет каждому процессу свою часть
+ * массива (тип данных выводится из T).
+ * @tparam T: тип значения в массиве.
+ * @param from_arr: массив, i-я часть которого отправляется процессу i.
+ * @param arr_len: количество элементов в части каждого процесса.
+ * @param to_arr: массив, i-я часть которого получается от процесса i.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void AllToAll(const T *from_arr, int arr_len, T *to_arr,
+                     MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
+  parallel::AllToAll(from_arr, arr_len, mpi_type<T>::get(), to_arr, arr_len,
+                     mpi_type<T>::get(), comm, need_print);
+}
+
+/**
+ * @brief Каждый процесс в сети MPI отправляет каждому процессу равную часть
+ * вектора (тип данных выводится из T).
+ * @tparam T: тип значения в векторе.
+ * @param from_vec: вектор, i-я часть которого отправляется процессу i
+ * (размер кратен количеству процессов).
+ * @param to_vec: вектор, i-я часть которого получается от процесса i (размер
+ * устанавливается равным `from_vec.size()`).
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void AllToAll(const std::vector<T> &from_vec, std::vector<T> &to_vec,
+                     MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
+  std::size_t ranks_amount = parallel::RanksAmount(comm);
+
+  if (from_vec.size() % ranks_amount != 0)
+    parallel::Error(
+        "parallel::AllToAll: vector size should be a multiple of ranks "
+        "amount.");
+
+  if (from_vec.size() / ranks_amount > INT_MAX)
+    parallel::Error("parallel::AllToAll: vector is too big (size > INT_MAX).");
+
+  int arr_len = static_cast<int>(from_vec.size() / ranks_amount);
+  to_vec.resize(from_vec.size());
+
+  parallel::AllToAll(from_vec.data(), arr_len, to_vec.data(), comm,
+                     need_print);
+}
+
+/**
+ * @brief Каждый процесс в сети MPI отправляет каждому процессу часть массива
+ * своего размера (MPI_Alltoallv).
+ * @tparam T: тип значения в массиве.
+ * @param from_arr: массив, части которого отправляются процессам.
+ * @param from_arr_datatype: тип данных элементов массива `from_arr`.
+ * @param from_arr_counts: количество значений, отправляемое каждому процессу.
+ * @param from_displacements: смещения частей в массиве `from_arr`.
+ * @param to_arr: массив, куда будут записаны полученные части.
+ * @param to_arr_datatype: тип данных элементов массива `to_arr`.
+ * @param to_arr_counts: количество значений, получаемое от каждого процесса.
+ * @param to_displacements: смещения частей в массиве `to_arr`.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void AllToAllVarious(const T *from_arr, MPI_Datatype from_arr_datatype,
+                            const int *from_arr_counts,
+                            const int *from_displacements, T *to_arr,
+                            MPI_Datatype to_arr_datatype,
+                            const int *to_arr_counts,
+                            const int *to_displacements,
+                            MPI_Comm comm = MPI_COMM_WORLD,
+                            bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::AllToAllVarious with args: from_arr: " << from_arr
+              << "; from_arr_datatype: " << from_arr_datatype
+              << "; from_arr_counts: " << from_arr_counts
+              << "; from_displacements: " << from_displacements
+              << "; to_arr: " << to_arr
+              << "; to_arr_datatype: " << to_arr_datatype
+              << "; to_arr_counts: " << to_arr_counts
+              << "; to_displacements: " << to_displacements
+              << "; comm: " << comm;
+
+  parallel::CheckSuccess(MPI_Alltoallv(
+      from_arr, from_arr_counts, from_displacements, from_arr_datatype, to_arr,
+      to_arr_counts, to_displacements, to_arr_datatype, comm));
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Каждый процесс в сети MPI отправляет каждому процессу часть массива
+ * своего размера (тип данных выводится из T).
+ * @tparam T: тип значения в массиве.
+ * @param from_arr: массив, части которого отправляются процессам.
+ * @param from_arr_counts: количество значений, отправляемое каждому процессу.
+ * @param from_displacements: смещения частей в массиве `from_arr`.
+ * @param to_arr: массив, куда будут записаны полученные части.
+ * @param to_arr_counts: количество значений, получаемое от каждого процесса.
+ * @param to_displacements: смещения частей в массиве `to_arr`.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void AllToAllVarious(const T *from_arr, const int *from_arr_counts,
+                            const int *from_displacements, T *to_arr,
+                            const int *to_arr_counts,
+                            const int *to_displacements,
+                            MPI_Comm comm = MPI_COMM_WORLD,
+                            bool need_print = false) {
+  parallel::AllToAllVarious(from_arr, mpi_type<T>::get(), from_arr_counts,
+                            from_displacements, to_arr, mpi_type<T>::get(),
+                            to_arr_counts, to_displacements, comm, need_print);
+}
+
+/**
+ * @brief Обменивается количествами значений для AllToAllVarious и вычисляет
+ * смещения частей.
+ * @param from_counts: количество значений, отправляемое каждому процессу.
+ * @param from_displacements: смещения отправляемых частей (выходной
+ * параметр).
+ * @param to_counts: количество значений, получаемое от каждого процесса
+ * (выходной параметр).
+ * @param to_displacements: смещения получаемых частей (выходной параметр).
+ * @param comm: коммуникатор MPI.
+ * @return std::size_t: общее количество получаемых значений.
+ */
+inline std::size_t AllToAllCounts(const int *from_counts,
+                                  int *from_displacements, int *to_counts,
+                                  int *to_displacements, MPI_Comm comm) {
+  int ranks_amount = parallel::RanksAmount(comm);
+
+  parallel::AllToAll(from_counts, 1, MPI_INT, to_counts, 1, MPI_INT, comm);
+
+  // смещения MPI_Alltoallv имеют тип int
+  long long from_total = 0, to_total = 0;
+  for (int i = 0; i < ranks_amount; i++) {
+    if (from_total + from_counts[i] > INT_MAX ||
+        to_total + to_counts[i] > INT_MAX)
+      parallel::Error(
+          "parallel::AllToAllVarious: vector is too big (size > INT_MAX).");
+
+    from_displacements[i] = static_cast<int>(from_total);
+    to_displacements[i] = static_cast<int>(to_total);
+
+    from_total += from_counts[i];
+    to_total += to_counts[i];
+  }
+
+  return static_cast<std::size_t>(to_total);
+}
+
+/**
+ * @brief Каждый процесс в сети MPI отправляет каждому процессу часть вектора
+ * своего размера; количества получаемых значений вычисляются автоматически
+ * (тип данных выводится из T).
+ * @details Части в `from_vec` идут подряд в порядке рангов получателей.
+ * Процессы сначала обмениваются количествами (MPI_Alltoall), смещения
+ * вычисляются на месте; служебные массивы берутся из parallel::BufferPool.
+ * @tparam T: тип значения в векторе.
+ * @param from_vec: вектор, части которого отправляются процессам.
+ * @param from_vec_counts: количество значений, отправляемое каждому процессу.
+ * @param to_vec: вектор, куда будут записаны полученные части в порядке
+ * рангов отправителей (размер устанавливается автоматически).
+ * @param to_vec_counts: количество значений, полученное от каждого процесса
+ * (выходной параметр).
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void AllToAllVarious(const std::vector<T> &from_vec,
+                            const std::vector<int> &from_vec_counts,
+                            std::vector<T> &to_vec,
+                            std::vector<int> &to_vec_counts,
+                            MPI_Comm comm = MPI_COMM_WORLD,
+                            bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::AllToAllVarious with args: from_vec: "
+              << from_vec.data() << "; from_vec_size: " << from_vec.size()
+              << "; from_vec_counts: " << from_vec_counts
+              << "; comm: " << comm << "; ";
+
+  int ranks_amount = parallel::RanksAmount(comm);
+
+  if (from_vec_counts.size() != static_cast<std::size_t>(ranks_amount))
+    parallel::Error(
+        "parallel::AllToAllVarious: counts size should be equal to ranks "
+        "amount.");
+
+  long long from_total = 0;
+  for (int i = 0; i < ranks_amount; i++) {
+    if (from_vec_counts[i] < 0)
+      parallel::Error(
+          "parallel::AllToAllVarious: counts should be non-negative.");
+
+    from_total += from_vec_counts[i];
+  }
+
+  if (from_total > static_cast<long long>(from_vec.size()))
+    parallel::Error(
+        "parallel::AllToAllVarious: sum of counts exceeds vector size.");
+
+  PooledBuffer<int> from_displacements(ranks_amount);
+  PooledBuffer<int> to_displacements(ranks_amount);
+  to_vec_counts.resize(ranks_amount);
+
+  to_vec.resize(parallel::AllToAllCounts(
+      from_vec_counts.data(), from_displacements.Data(), to_vec_counts.data(),
+      to_displacements.Data(), comm));
+
+  parallel::AllToAllVarious(from_vec.data(), from_vec_counts.data(),
+                            from_displacements.Data(), to_vec.data(),
+                            to_vec_counts.data(), to_displacements.Data(),
+                            comm);
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Каждый процесс в сети MPI отправляет каждому процессу часть вектора
+ * своего размера; количества получаемых значений вычисляются автоматически
+ * (тип данных выводится из T).
+ * @details Части в `from_vec` идут подряд в порядке рангов получателей.
+ * @tparam T: тип значения в векторе.
+ * @param from_vec: вектор, части которого отправляются процессам.
+ * @param from_vec_counts: количество значений, отправляемое каждому процессу.
+ * @param to_vec: вектор, куда будут записаны полученные части в порядке
+ * рангов отправителей (размер устанавливается автоматически).
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void AllToAllVarious(const std::vector<T> &from_vec,
+                            const std::vector<int> &from_vec_counts,
+                            std::vector<T> &to_vec,
+                            MPI_Comm comm = MPI_COMM_WORLD,
+                            bool need_print = false) {
+  std::vector<int> to_vec_counts;
+
+  parallel::AllToAllVarious(from_vec, from_vec_counts, to_vec, to_vec_counts,
+                            comm, need_print);
+}
+
+/**
+ * @brief Выполняет операцию над большим массивом значений по кольцу и
+ * рассылает результат всем процессам в сети MPI.
+ * @details Массив делится на RanksAmount(comm) блоков. За p - 1 шагов
+ * редукции с раздачей (reduce-scatter) каждый процесс получает от левого
+ * соседа частичный результат блока, добавляет свой и передаёт правому, после
+ * чего у процесса r готов блок r + 1. Ещё за p - 1 шагов кольцевого сбора
+ * (allgather) готовые блоки расходятся по всем процессам. Каждый процесс
+ * передаёт около 2 * (p - 1) / p массива независимо от p. Блоки идут частями
+ * по PARALLEL_RING_SEGMENT_BYTES: часть уходит дальше неблокирующей
+ * отправкой, как только посчитана, пока принимаются следующие. Операция
+ * должна быть коммутативной, тип данных - сплошным.
+ * @tparam T: тип значения в массиве.
+ * @param from_arr: исходный массив значений (может совпадать с to_arr).
+ * @param to_arr: массив, куда будет записан результат операции.
+ * @param arr_len: количество элементов в массиве.
+ * @param datatype: тип данных элементов массива.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void RingAllOperation(const T *from_arr, T *to_arr, int arr_len,
+                             MPI_Datatype datatype, MPI_Op op,
+                             MPI_Comm comm = MPI_COMM_WORLD,
+                             bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::RingAllOperation with args: from_arr: " << from_arr
+              << "; to_arr: " << to_arr << "; arr_len: " << arr_len
+              << "; datatype: " << datatype << "; op: " << op
+              << "; comm: " << comm;
+
+  if (arr_len < 0)
+    parallel::Error(
+        "parallel::RingAllOperation: arr_len should be non-negative.");
+
+  MPI_Aint lower_bound, extent;
+  parallel::CheckSuccess(MPI_Type_get_extent(datatype, &lower_bound, &extent));
+
+  char *bytes = reinterpret_cast<char *>(to_arr);
+
+  if (from_arr != to_arr)
+    std::memcpy(bytes, from_arr, static_cast<std::size_t>(arr_len) * extent);
+
+  int ranks_amount = parallel::RanksAmount(comm);
+  int curr_rank = parallel::CurrRank(comm);
+
+  if (ranks_amount == 1) {
+    if (need_print) std::cout << "SUCCESS" << std::endl;
+    return;
+  }
+
+  int left = (curr_rank - 1 + ranks_amount) % ranks_amount;
+  int right = (curr_rank + 1) % ranks_amount;
+
+  int max_block_len = (arr_len + ranks_amount - 1) / ranks_amount;
+  int segment_len = static_cast<int>(
+      Min(std::max(static_cast<std::size_t>(PARALLEL_RING_SEGMENT_BYTES) /
+                       static_cast<std::size_t>(extent),
+                   static_cast<std::size_t>(1)),
+          static_cast<std::size_t>(std::max(max_block_len, 1))));
+  int segments_amount = (max_block_len + segment_len - 1) / segment_len;
+
+  // часть segment блока index: начало (в элементах) и длина
+  auto segment_begin = [&](int index, int segment) {
+    int begin, end;
+    parallel::BalancedRange(arr_len, ranks_amount, index, begin, end);
+    return Min(begin + segment * segment_len, end);
+  };
+  auto segment_size = [&](int index, int segment) {
+    int begin, end;
+    parallel::BalancedRange(arr_len, ranks_amount, index, begin, end);
+    return Min(begin + (segment + 1) * segment_len, end) -
+           segment_begin(index, segment);
+  };
+  auto at = [&](char *base, int offset) {
+    return base + static_cast<MPI_Aint>(offset) * extent;
+  };
+  auto block = [&](int shift) {
+    return ((curr_rank + shift) % ranks_amount + ranks_amount) % ranks_amount;
+  };
+
+  int steps = ranks_amount - 1;
+  PooledBuffer<MPI_Request> sends(steps * segments_amount);
+  PooledBuffer<MPI_Request> recvs(steps * segments_amount);
+  PooledBuffer<char> received(2 * static_cast<std::size_t>(max_block_len) *
+                              extent);
+
+  // на шаге step принимается блок curr_rank - step - 1 в половину step % 2
+  auto post_recvs = [&](int step) {
+    char *half = received.Data() + (step % 2) * max_block_len * extent;
+    int index = block(-step - 1);
+
+    for (int s = 0; s < segments_amount; s++)
+      parallel::CheckSuccess(MPI_Irecv(
+          at(half, segment_begin(index, s) - segment_begin(index, 0)),
+          segment_size(index, s), datatype, left, PARALLEL_COLLECTIVE_TAG,
+          comm, &recvs[step * segments_amount + s]));
+  };
+  auto send_segment = [&](int step, int index, int s) {
+    parallel::CheckSuccess(MPI_Isend(
+        at(bytes, segment_begin(index, s)), segment_size(index, s), datatype,
+        right, PARALLEL_COLLECTIVE_TAG, comm,
+        &sends[step * segments_amount + s]));
+  };
+
+  // reduce-scatter
+  post_recvs(0);
+  for (int s = 0; s < segments_amount; s++) send_segment(0, block(0), s);
+
+  for (int step = 0; step < steps; step++) {
+    if (step + 1 < steps) post_recvs(step + 1);
+
+    char *half = received.Data() + (step % 2) * max_block_len * extent;
+    int index = block(-step - 1);
+
+    for (int s = 0; s < segments_amount; s++) {
+      parallel::CheckSuccess(
+          MPI_Wait(&recvs[step * segments_amount + s], MPI_STATUS_IGNORE));
+
+      int offset = segment_begin(index, s);
+      parallel::CheckSuccess(MPI_Reduce_local(
+          at(half, offset - segment_begin(index, 0)), at(bytes, offset),
+          segment_size(index, s), datatype, op));
+
+      if (step + 1 < steps) send_segment(step + 1, index, s);
+    }
+  }
+
+  parallel::CheckSuccess(
+      MPI_Waitall(steps * segments_amount, sends.Data(), MPI_STATUSES_IGNORE));
+
+  // allgather: готовый блок curr_rank + 1 идёт по кольцу, чужие блоки
+  // принимаются сразу на место
+  for (int step = 0; step < steps; step++) {
+    int index = block(-step);
+
+    for (int s = 0; s < segments_amount; s++)
+      parallel::CheckSuccess(MPI_Irecv(
+          at(bytes, segment_begin(index, s)), segment_size(index, s), datatype,
+          left, PARALLEL_COLLECTIVE_TAG, comm,
+          &recvs[step * segments_amount + s]));
+  }
+
+  for (int s = 0; s < segments_amount; s++) send_segment(0, block(1), s);
+
+  for (int step = 0; step < steps; step++)
+    for (int s = 0; s < segments_amount; s++) {
+      parallel::CheckSuccess(
+          MPI_Wait(&recvs[step * segments_amount + s], MPI_STATUS_IGNORE));
+
+      if (step + 1 < steps) send_segment(step + 1, block(-step), s);
+    }
+
+  parallel::CheckSuccess(
+      MPI_Waitall(steps * segments_amount, sends.Data(), MPI_STATUSES_IGNORE));
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Выполняет операцию над большим массивом значений по кольцу и
+ * рассылает результат всем процессам в сети MPI (тип данных выводится из T).
+ * @tparam T: тип значения в массиве.
+ * @param from_arr: исходный массив значений (может совпадать с to_arr).
+ * @param to_arr: массив, куда будет записан результат операции.
+ * @param arr_len: количество элементов в массиве.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void RingAllOperation(const T *from_arr, T *to_arr, int arr_len,
+                             MPI_Op op, MPI_Comm comm = MPI_COMM_WORLD,
+                             bool need_print = false) {
+  parallel::RingAllOperation(from_arr, to_arr, arr_len, mpi_type<T>::get(), op,
+                             comm, need_print);
+}
+
+/**
+ * @brief Выполняет операцию над большим вектором значений по кольцу и
+ * рассылает результат всем процессам в сети MPI (тип данных выводится из T).
+ * @tparam T: тип значения в векторе.
+ * @param from_vec: исходный вектор значений.
+ * @param to_vec: вектор, куда будет записан результат операции.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void RingAllOperation(const std::vector<T> &from_vec,
+                             std::vector<T> &to_vec, MPI_Op op,
+                             MPI_Comm comm = MPI_COMM_WORLD,
+                             bool need_print = false) {
+  std::size_t arr_len = Min(from_vec.size(), to_vec.size());
+
+  if (arr_len > INT_MAX)
+    parallel::Error(
+        "parallel::RingAllOperation: vector is too big (size > INT_MAX).");
+
+  parallel::RingAllOperation(from_vec.data(), to_vec.data(),
+                             static_cast<int>(arr_len), mpi_type<T>::get(), op,
+                             comm, need_print);
+}
+
+/**
+ * @brief Выполняет операцию над большим вектором значений по кольцу и
+ * записывает результат на его место во всех процессах в сети MPI (тип
+ * данных выводится из T).
+ * @tparam T: тип значения в векторе.
+ * @param vec: исходный вектор значений и результат операции.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void RingAllOperation(std::vector<T> &vec, MPI_Op op,
+                             MPI_Comm comm = MPI_COMM_WORLD,
+                             bool need_print = false) {
+  if (vec.size() > INT_MAX)
+    parallel::Error(
+        "parallel::RingAllOperation: vector is too big (size > INT_MAX).");
+
+  parallel::RingAllOperation(vec.data(), vec.data(),
+                             static_cast<int>(vec.size()), mpi_type<T>::get(),
+                             op, comm, need_print);
+}
+
+/**
+ * @brief Двухуровневое разбиение коммуникатора для иерархических
+ * коллективных операций: процессы одного узла и лидеры узлов.
+ * @details Лидер узла - процесс с рангом 0 в коммуникаторе узла; лидером
+ * узла процесса с рангом 0 в comm всегда является он сам.
+ */
+struct HierarchyComms {
+  /// @brief процессы того же узла (parallel::NodeComm)
+  MPI_Comm node;
+  /// @brief лидеры узлов (на остальных процессах MPI_COMM_NULL)
+  MPI_Comm leaders;
+  /// @brief копия comm для пересылок между процессом 0 и корнем операции
+  MPI_Comm forward;
+  /// @brief размеры узлов в порядке рангов leaders (на ранге 0 comm)
+  std::vector<int> node_sizes;
+  /// @brief ранги comm в порядке узлов, как их собирают лидеры (на ранге 0)
+  std::vector<int> ranks_by_node;
+};
+
+/**
+ * @brief Возвращает двухуровневое разбиение коммуникатора, создавая его при
+ * первом запросе (коллективно по comm).
+ * @details Разбиения кэшируются по comm и живут до завершения работы с MPI,
+ * поэтому иерархические операции не создают коммуникаторы заново.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ * @return const HierarchyComms&: разбиение коммуникатора.
+ */
+inline const HierarchyComms &Hierarchy(MPI_Comm comm = MPI_COMM_WORLD,
+                                       bool need_print = false) {
+  static std::map<MPI_Comm, HierarchyComms> cache;
+  static std::mutex cache_mutex;
+
+  if (need_print)
+    std::cout << "parallel::Hierarchy with args: comm: " << comm << "; ";
+
+  std::lock_guard<std::mutex> lock(cache_mutex);
+
+  auto it = cache.find(comm);
+  if (it != cache.end()) {
+    if (need_print) std::cout << "SUCCESS" << std::endl;
+    return it->second;
+  }
+
+  HierarchyComms hierarchy;
+  hierarchy.node = parallel::NodeComm(comm);
+
+  int curr_rank = parallel::CurrRank(comm);
+  int node_rank = parallel::CurrRank(hierarchy.node);
+  int node_size = parallel::RanksAmount(hierarchy.node);
+
+  int leaders_color = node_rank == 0 ? 0 : MPI_UNDEFINED;
+  parallel::CheckSuccess(
+      MPI_Comm_split(comm, leaders_color, curr_rank, &hierarchy.leaders));
+
+  // пересылки не должны пересекаться с сообщениями пользователя на comm
+  parallel::CheckSuccess(MPI_Comm_dup(comm, &hierarchy.forward));
+
+  std::vector<int> node_ranks(node_rank == 0 ? node_size : 0);
+  parallel::CheckSuccess(MPI_Gather(&curr_rank, 1, MPI_INT, node_ranks.data(),
+                                    1, MPI_INT, 0, hierarchy.node));
+
+  if (hierarchy.leaders != MPI_COMM_NULL) {
+    int leaders_amount = parallel::RanksAmount(hierarchy.leaders);
+    std::vector<int> displacements;
+
+    if (curr_rank == 0) {
+      hierarchy.node_sizes.resize(leaders_amount);
+      hierarchy.ranks_by_node.resize(parallel::RanksAmount(comm));
+    }
+
+    parallel::CheckSuccess(MPI_Gather(&node_size, 1, MPI_INT,
+                                      hierarchy.node_sizes.data(), 1, MPI_INT,
+                                      0, hierarchy.leaders));
+
+    if (curr_rank == 0) {
+      displacements.resize(leaders_amount, 0);
+      for (int i = 0; i < leaders_amount - 1; i++)
+        displacements[i + 1] = displacements[i] + hierarchy.node_sizes[i];
+    }
+
+    parallel::CheckSuccess(MPI_Gatherv(
+        node_ranks.data(), node_size, MPI_INT, hierarchy.ranks_by_node.data(),
+        hierarchy.node_sizes.data(), displacements.data(), MPI_INT, 0,
+        hierarchy.leaders));
+  }
+
+  const HierarchyComms &cached = cache[comm] = hierarchy;
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+
+  return cached;
+}
+
+/**
+ * @brief Выполняет операцию над массивом значений в два уровня и отправляет
+ * результат на указанный процесс в сети MPI.
+ * @details Сначала редукция внутри каждого узла к его лидеру (по общей
+ * памяти), затем между лидерами узлов к процессу 0 и, если нужно, пересылка
+ * результата процессу `to_rank`. Межузловой трафик - одно сообщение на узел.
+ * Порядок применения op отличается от MPI_Reduce, поэтому операция должна
+ * быть коммутативной. Тип данных должен описывать T целиком.
+ * @tparam T: тип значения в массиве.
+ * @param from_arr: исходный массив значений, над которым выполняется операция.
+ * @param to_arr: массив, куда будет записан результат операции.
+ * @param arr_len: количество элементов в массиве.
+ * @param datatype: тип данных элементов массива.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param to_rank: ранг процесса результата. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void HierarchicalOperation(const T *from_arr, T *to_arr, int arr_len,
+                                  MPI_Datatype datatype, MPI_Op op,
+                                  unsigned int to_rank = 0,
+                                  MPI_Comm comm = MPI_COMM_WORLD,
+                                  bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::HierarchicalOperation with args: from_arr: "
+              << from_arr << "; to_arr: " << to_arr
+              << "; arr_len: " << arr_len << "; datatype: " << datatype
               << "; op: " << op << "; to_rank: " << to_rank
               << "; comm: " << comm;
 
+  if (arr_len < 0)
+    parallel::Error(
+        "parallel::HierarchicalOperation: arr_len should be non-negative.");
+
+  const HierarchyComms &hierarchy = parallel::Hierarchy(comm);
+  int curr_rank = parallel::CurrRank(comm);
+  bool is_leader = hierarchy.leaders != MPI_COMM_NULL;
+
+  PooledBuffer<char> node_buffer(is_leader ? arr_len * sizeof(T) : 0);
+  T *node_arr = reinterpret_cast<T *>(node_buffer.Data());
+
+  parallel::CheckSuccess(MPI_Reduce(from_arr, node_arr, arr_len, datatype, op,
+                                    0, hierarchy.node));
+
+  if (is_leader) {
+    // на процессе 0 результат сразу пишется в to_arr, если он адресован ему
+    if (curr_rank == 0 && to_rank == 0)
+      parallel::CheckSuccess(MPI_Reduce(node_arr, to_arr, arr_len, datatype,
+                                        op, 0, hierarchy.leaders));
+    else if (curr_rank == 0)
+      parallel::CheckSuccess(MPI_Reduce(MPI_IN_PLACE, node_arr, arr_len,
+                                        datatype, op, 0, hierarchy.leaders));
+    else
+      parallel::CheckSuccess(MPI_Reduce(node_arr, nullptr, arr_len, datatype,
+                                        op, 0, hierarchy.leaders));
+  }
+
+  if (to_rank != 0) {
+    if (curr_rank == 0)
+      parallel::CheckSuccess(MPI_Send(node_arr, arr_len, datatype, to_rank,
+                                      PARALLEL_SERVICE_TAG,
+                                      hierarchy.forward));
+    else if (curr_rank == static_cast<int>(to_rank))
+      parallel::CheckSuccess(MPI_Recv(to_arr, arr_len, datatype, 0,
+                                      PARALLEL_SERVICE_TAG, hierarchy.forward,
+                                      MPI_STATUS_IGNORE));
+  }
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Выполняет операцию над массивом значений в два уровня и рассылает
+ * результат всем процессам в сети MPI.
+ * @details Редукция внутри узла к лидеру, MPI_Allreduce между лидерами и
+ * рассылка результата внутри узла. Операция должна быть коммутативной.
+ * @tparam T: тип значения в массиве.
+ * @param from_arr: исходный массив значений (может совпадать с to_arr).
+ * @param to_arr: массив, куда будет записан результат операции.
+ * @param arr_len: количество элементов в массиве.
+ * @param datatype: тип данных элементов массива.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void HierarchicalAllOperation(const T *from_arr, T *to_arr, int arr_len,
+                                     MPI_Datatype datatype, MPI_Op op,
+                                     MPI_Comm comm = MPI_COMM_WORLD,
+                                     bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::HierarchicalAllOperation with args: from_arr: "
+              << from_arr << "; to_arr: " << to_arr
+              << "; arr_len: " << arr_len << "; datatype: " << datatype
+              << "; op: " << op << "; comm: " << comm;
+
+  if (arr_len < 0)
+    parallel::Error(
+        "parallel::HierarchicalAllOperation: arr_len should be "
+        "non-negative.");
+
+  const HierarchyComms &hierarchy = parallel::Hierarchy(comm);
+  bool is_leader = hierarchy.leaders != MPI_COMM_NULL;
+
+  const void *send_buffer = from_arr;
+  if (is_leader && from_arr == to_arr) send_buffer = MPI_IN_PLACE;
+
+  parallel::CheckSuccess(MPI_Reduce(send_buffer, to_arr, arr_len, datatype, op,
+                                    0, hierarchy.node));
+
+  if (is_leader)
+    parallel::CheckSuccess(MPI_Allreduce(MPI_IN_PLACE, to_arr, arr_len,
+                                         datatype, op, hierarchy.leaders));
+
+  parallel::CheckSuccess(MPI_Bcast(to_arr, arr_len, datatype, 0,
+                                   hierarchy.node));
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Рассылает массив от процесса с указанным рангом по сети MPI в два
+ * уровня: между лидерами узлов, затем внутри каждого узла.
+ * @details Если from_rank не 0, массив сначала пересылается процессу 0
+ * (по копии comm из parallel::Hierarchy).
+ * @tparam T: тип элементов рассылаемого массива.
+ * @param arr: рассылаемый массив (на остальных процессах - куда записать).
+ * @param arr_len: количество элементов в массиве.
+ * @param datatype: тип данных элементов массива.
+ * @param from_rank: ранг процесса рассылки. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void HierarchicalBroadcast(T *arr, int arr_len, MPI_Datatype datatype,
+                                  int from_rank = 0,
+                                  MPI_Comm comm = MPI_COMM_WORLD,
+                                  bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::HierarchicalBroadcast with args: arr: " << arr
+              << "; arr_len: " << arr_len << "; datatype: " << datatype
+              << "; from_rank: " << from_rank << "; comm: " << comm;
+
+  if (arr_len < 0)
+    parallel::Error(
+        "parallel::HierarchicalBroadcast: arr_len should be non-negative.");
+
+  const HierarchyComms &hierarchy = parallel::Hierarchy(comm);
+  int curr_rank = parallel::CurrRank(comm);
+
+  if (from_rank != 0) {
+    if (curr_rank == from_rank)
+      parallel::CheckSuccess(MPI_Send(arr, arr_len, datatype, 0,
+                                      PARALLEL_SERVICE_TAG,
+                                      hierarchy.forward));
+    else if (curr_rank == 0)
+      parallel::CheckSuccess(MPI_Recv(arr, arr_len, datatype, from_rank,
+                                      PARALLEL_SERVICE_TAG, hierarchy.forward,
+                                      MPI_STATUS_IGNORE));
+  }
+
+  if (hierarchy.leaders != MPI_COMM_NULL)
+    parallel::CheckSuccess(
+        MPI_Bcast(arr, arr_len, datatype, 0, hierarchy.leaders));
+
+  parallel::CheckSuccess(MPI_Bcast(arr, arr_len, datatype, 0, hierarchy.node));
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Собирает массивы одинаковой длины от всех процессов в сети MPI в
+ * одном процессе в два уровня: внутри узла к лидеру, затем от лидеров.
+ * @details Блоки собираются в порядке узлов и раскладываются в `to_arr` по
+ * рангам comm, поэтому результат совпадает с parallel::Gather. Тип данных
+ * должен описывать T целиком.
+ * @tparam T: тип значения в массиве.
+ * @param from_arr: массив, который будет отправлен от текущего процесса.
+ * @param arr_len: количество элементов в массиве `from_arr`.
+ * @param to_arr: массив из arr_len * RanksAmount(comm) элементов, куда будет
+ * записан результат сбора на процессе `to_rank`.
+ * @param datatype: тип данных элементов массивов.
+ * @param to_rank: ранг процесса результата. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void HierarchicalGather(const T *from_arr, int arr_len, T *to_arr,
+                               MPI_Datatype datatype, unsigned int to_rank = 0,
+                               MPI_Comm comm = MPI_COMM_WORLD,
+                               bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::HierarchicalGather with args: from_arr: "
+              << from_arr << "; arr_len: " << arr_len << "; to_arr: " << to_arr
+              << "; datatype: " << datatype << "; to_rank: " << to_rank
+              << "; comm: " << comm;
+
+  if (arr_len < 0)
+    parallel::Error(
+        "parallel::HierarchicalGather: arr_len should be non-negative.");
+
+  const HierarchyComms &hierarchy = parallel::Hierarchy(comm);
+  int curr_rank = parallel::CurrRank(comm);
+  int ranks_amount = parallel::RanksAmount(comm);
+
+  if (static_cast<std::size_t>(arr_len) * ranks_amount > INT_MAX)
+    parallel::Error("parallel::HierarchicalGather: result is too big.");
+
+  bool is_leader = hierarchy.leaders != MPI_COMM_NULL;
+  int node_size = parallel::RanksAmount(hierarchy.node);
+  std::size_t block_bytes = arr_len * sizeof(T);
+
+  PooledBuffer<char> node_buffer(is_leader ? node_size * block_bytes : 0);
+  PooledBuffer<char> nodes_buffer(curr_rank == 0 ? ranks_amount * block_bytes
+                                                 : 0);
+
+  parallel::CheckSuccess(MPI_Gather(from_arr, arr_len, datatype,
+                                    node_buffer.Data(), arr_len, datatype, 0,
+                                    hierarchy.node));
+
+  if (is_leader) {
+    int leaders_amount = parallel::RanksAmount(hierarchy.leaders);
+    PooledBuffer<int> counts(curr_rank == 0 ? leaders_amount : 0);
+    PooledBuffer<int> displacements(curr_rank == 0 ? leaders_amount : 0);
+
+    for (std::size_t i = 0; i < counts.Size(); i++) {
+      counts[i] = hierarchy.node_sizes[i] * arr_len;
+      displacements[i] = i == 0 ? 0 : displacements[i - 1] + counts[i - 1];
+    }
+
+    parallel::CheckSuccess(MPI_Gatherv(
+        node_buffer.Data(), node_size * arr_len, datatype, nodes_buffer.Data(),
+        counts.Data(), displacements.Data(), datatype, 0, hierarchy.leaders));
+  }
+
+  if (curr_rank == 0) {
+    // блоки пришли в порядке узлов: раскладываем по рангам comm
+    PooledBuffer<char> ordered(to_rank == 0 ? 0 : ranks_amount * block_bytes);
+    char *result =
+        to_rank == 0 ? reinterpret_cast<char *>(to_arr) : ordered.Data();
+
+    for (int i = 0; i < ranks_amount; i++)
+      std::memcpy(result + hierarchy.ranks_by_node[i] * block_bytes,
+                  nodes_buffer.Data() + i * block_bytes, block_bytes);
+
+    if (to_rank != 0)
+      parallel::CheckSuccess(MPI_Send(result, ranks_amount * arr_len, datatype,
+                                      to_rank, PARALLEL_SERVICE_TAG,
+                                      hierarchy.forward));
+  } else if (curr_rank == static_cast<int>(to_rank)) {
+    parallel::CheckSuccess(MPI_Recv(to_arr, ranks_amount * arr_len, datatype, 0,
+                                    PARALLEL_SERVICE_TAG, hierarchy.forward,
+                                    MPI_STATUS_IGNORE));
+  }
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Выполняет операцию над значением в два уровня и отправляет
+ * результат на указанный процесс в сети MPI (тип данных выводится из T).
+ * @tparam T: тип значения.
+ * @param from_value: исходное значение, над которым выполняется операция.
+ * @param to_value: значение, куда будет записан результат операции.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param to_rank: ранг процесса результата. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T,
+          typename = typename std::enable_if<is_mpi_type<T>::value>::type>
+inline void HierarchicalOperation(const T &from_value, T &to_value, MPI_Op op,
+                                  unsigned int to_rank = 0,
+                                  MPI_Comm comm = MPI_COMM_WORLD,
+                                  bool need_print = false) {
+  parallel::HierarchicalOperation(&from_value, &to_value, 1, mpi_type<T>::get(),
+                                  op, to_rank, comm, need_print);
+}
+
+/**
+ * @brief Выполняет операцию над вектором значений в два уровня и отправляет
+ * результат на указанный процесс в сети MPI (тип данных выводится из T).
+ * @tparam T: тип значения в векторе.
+ * @param from_vec: исходный вектор значений, над которым выполняется операция.
+ * @param to_vec: вектор, куда будет записан результат операции.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param to_rank: ранг процесса результата. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void HierarchicalOperation(const std::vector<T> &from_vec,
+                                  std::vector<T> &to_vec, MPI_Op op,
+                                  unsigned int to_rank = 0,
+                                  MPI_Comm comm = MPI_COMM_WORLD,
+                                  bool need_print = false) {
+  std::size_t arr_len = from_vec.size();
+
+  if (arr_len > INT_MAX)
+    parallel::Error(
+        "parallel::HierarchicalOperation: vector is too big (size > "
+        "INT_MAX).");
+
+  if (parallel::CurrRank(comm) == static_cast<int>(to_rank) &&
+      to_vec.size() < arr_len)
+    to_vec.resize(arr_len);
+
+  parallel::HierarchicalOperation(from_vec.data(), to_vec.data(),
+                                  static_cast<int>(arr_len),
+                                  mpi_type<T>::get(), op, to_rank, comm,
+                                  need_print);
+}
+
+/**
+ * @brief Выполняет операцию над значением в два уровня и рассылает
+ * результат всем процессам в сети MPI (тип данных выводится из T).
+ * @tparam T: тип значения.
+ * @param from_value: исходное значение, над которым выполняется операция.
+ * @param to_value: значение, куда будет записан результат операции.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T,
+          typename = typename std::enable_if<is_mpi_type<T>::value>::type>
+inline void HierarchicalAllOperation(const T &from_value, T &to_value,
+                                     MPI_Op op, MPI_Comm comm = MPI_COMM_WORLD,
+                                     bool need_print = false) {
+  parallel::HierarchicalAllOperation(&from_value, &to_value, 1,
+                                     mpi_type<T>::get(), op, comm, need_print);
+}
+
+/**
+ * @brief Выполняет операцию над вектором значений в два уровня и рассылает
+ * результат всем процессам в сети MPI (тип данных выводится из T).
+ * @tparam T: тип значения в векторе.
+ * @param from_vec: исходный вектор значений, над которым выполняется операция.
+ * @param to_vec: вектор, куда будет записан результат операции.
+ * @param op: операция MPI, которая будет выполнена.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void HierarchicalAllOperation(const std::vector<T> &from_vec,
+                                     std::vector<T> &to_vec, MPI_Op op,
+                                     MPI_Comm comm = MPI_COMM_WORLD,
+                                     bool need_print = false) {
+  std::size_t arr_len = from_vec.size();
+
+  if (arr_len > INT_MAX)
+    parallel::Error(
+        "parallel::HierarchicalAllOperation: vector is too big (size > "
+        "INT_MAX).");
+
+  if (to_vec.size() < arr_len) to_vec.resize(arr_len);
+
+  parallel::HierarchicalAllOperation(from_vec.data(), to_vec.data(),
+                                     static_cast<int>(arr_len),
+                                     mpi_type<T>::get(), op, comm, need_print);
+}
+
+/**
+ * @brief Рассылает значение от процесса с указанным рангом по сети MPI в два
+ * уровня (тип данных выводится из T).
+ * @tparam T: тип рассылаемого значения.
+ * @param value: рассылаемое значение.
+ * @param from_rank: ранг процесса рассылки. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T,
+          typename = typename std::enable_if<is_mpi_type<T>::value>::type>
+inline void HierarchicalBroadcast(T &value, int from_rank = 0,
+                                  MPI_Comm comm = MPI_COMM_WORLD,
+                                  bool need_print = false) {
+  parallel::HierarchicalBroadcast(&value, 1, mpi_type<T>::get(), from_rank,
+                                  comm, need_print);
+}
+
+/**
+ * @brief Рассылает вектор от процесса с указанным рангом по сети MPI в два
+ * уровня (тип данных выводится из T). Размеры векторов должны совпадать.
+ * @tparam T: тип элементов рассылаемого вектора.
+ * @param vec: рассылаемый вектор.
+ * @param from_rank: ранг процесса рассылки. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void HierarchicalBroadcast(std::vector<T> &vec, int from_rank = 0,
+                                  MPI_Comm comm = MPI_COMM_WORLD,
+                                  bool need_print = false) {
+  if (vec.size() > INT_MAX)
+    parallel::Error(
+        "parallel::HierarchicalBroadcast: vector is too big (size > "
+        "INT_MAX).");
+
+  parallel::HierarchicalBroadcast(vec.data(), static_cast<int>(vec.size()),
+                                  mpi_type<T>::get(), from_rank, comm,
+                                  need_print);
+}
+
+/**
+ * @brief Собирает значения от всех процессов в сети MPI в одном процессе в
+ * два уровня (тип данных выводится из T).
+ * @tparam T: тип значения.
+ * @param from_value: значение, которое будет отправлено.
+ * @param to_arr: массив из RanksAmount(comm) элементов на процессе `to_rank`.
+ * @param to_rank: ранг процесса результата. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T,
+          typename = typename std::enable_if<is_mpi_type<T>::value>::type>
+inline void HierarchicalGather(const T &from_value, T *to_arr,
+                               unsigned int to_rank = 0,
+                               MPI_Comm comm = MPI_COMM_WORLD,
+                               bool need_print = false) {
+  parallel::HierarchicalGather(&from_value, 1, to_arr, mpi_type<T>::get(),
+                               to_rank, comm, need_print);
+}
+
+/**
+ * @brief Собирает векторы одинаковой длины от всех процессов в сети MPI в
+ * одном процессе в два уровня (тип данных выводится из T).
+ * @tparam T: тип значения в векторе.
+ * @param from_vec: вектор, который будет отправлен от текущего процесса.
+ * @param to_vec: вектор, куда будет записан результат сбора на процессе
+ * `to_rank` (размер устанавливается автоматически).
+ * @param to_rank: ранг процесса результата. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void HierarchicalGather(const std::vector<T> &from_vec,
+                               std::vector<T> &to_vec, unsigned int to_rank = 0,
+                               MPI_Comm comm = MPI_COMM_WORLD,
+                               bool need_print = false) {
   if (from_vec.size() > INT_MAX)
-    parallel::Error("parallel::Operation: vector is too big (size > INT_MAX).");
+    parallel::Error(
+        "parallel::HierarchicalGather: vector is too big (size > INT_MAX).");
+
+  if (parallel::CurrRank(comm) == static_cast<int>(to_rank))
+    to_vec.resize(from_vec.size() * parallel::RanksAmount(comm));
+
+  parallel::HierarchicalGather(from_vec.data(),
+                               static_cast<int>(from_vec.size()),
+                               to_vec.data(), mpi_type<T>::get(), to_rank,
+                               comm, need_print);
+}
+
+/**
+ * @brief Отправляет несплошную область по сети MPI без копирования.
+ * @tparam T: тип элементов области.
+ * @param view: отправляемая область (parallel::StridedView,
+ * parallel::SubarrayView).
+ * @param to_rank: ранг получателя.
+ * @param tag: тег сообщения. По умолчанию PARALLEL_STANDARD_TAG.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void Send(View<T> view, unsigned int to_rank,
+                 int tag = PARALLEL_STANDARD_TAG,
+                 MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::Send with args: view: " << view.Data()
+              << "; view_size: " << view.Size() << "; to_rank: " << to_rank
+              << "; tag: " << tag << "; comm: " << comm;
 
-  parallel::Operation(
-      from_vec.data(), to_vec.data(),
-      Min(static_cast<int>(from_vec.size()), static_cast<int>(to_vec.size())),
-      datatype, op, to_rank, comm);
+  parallel::CheckSuccess(
+      MPI_Send(view.Data(), 1, view.Datatype(), to_rank, tag, comm));
 
   if (need_print) std::cout << "SUCCESS" << std::endl;
 }
 
 /**
- * @brief Собирать значения от всех процессов в сети MPI в одном процессе.
- * @tparam T: тип значения.
- * @param from_value: значение, которое будет отправлено от текущего процесса.
- * @param from_value_datatype: тип данных `from_value`.
- * @param to_value: ссылка на значение, куда будет записан результат сбора на
- * процессе `to_rank`.
- * @param to_value_datatype: тип данных `to_value`.
- * @param to_rank: ранг процесса результата. По умолчанию 0.
+ * @brief Начинает неблокирующую отправку несплошной области по сети MPI без
+ * копирования.
+ * @tparam T: тип элементов области.
+ * @param view: отправляемая область (память должна жить до завершения
+ * операции).
+ * @param to_rank: ранг получателя.
+ * @param tag: тег сообщения. По умолчанию PARALLEL_STANDARD_TAG.
  * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ * @return parallel::Request: дескриптор операции.
  */
 template <typename T>
-inline void Gather(const T &from_value, MPI_Datatype from_value_datatype,
-                   T &to_value, MPI_Datatype to_value_datatype,
-                   unsigned int to_rank = 0, MPI_Comm comm = MPI_COMM_WORLD,
-                   bool need_print = false) {
+inline Request ISend(View<T> view, unsigned int to_rank,
+                     int tag = PARALLEL_STANDARD_TAG,
+                     MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
   if (need_print)
-    std::cout << "parallel::Gather with args: from_value: " << from_value
-              << "; from_value_datatype: " << from_value_datatype
-              << "; to_value: " << to_value
-              << "; to_value_datatype: " << to_value_datatype
-              << "; to_rank: " << to_rank << "; comm: " << comm;
+    std::cout << "parallel::ISend with args: view: " << view.Data()
+              << "; view_size: " << view.Size() << "; to_rank: " << to_rank
+              << "; tag: " << tag << "; comm: " << comm;
 
-  parallel::CheckSuccess(MPI_Gather(&from_value, 1, from_value_datatype,
-                                    &to_value, 1, to_value_datatype, to_rank,
-                                    comm));
+  MPI_Request request;
+  parallel::CheckSuccess(MPI_Isend(view.Data(), 1, view.Datatype(), to_rank,
+                                   tag, comm, &request));
 
   if (need_print) std::cout << "SUCCESS" << std::endl;
+
+  return Request(request);
 }
 
 /**
- * @brief Собирает массивы от всех процессов в сети MPI в одном процессе.
- * @tparam T: тип значения в массиве.
- * @param from_arr: массив, который будет отправлен от текущего процесса.
- * @param from_arr_len: количество элементов в массиве `from_arr`.
- * @param from_arr_datatype: тип данных элементов массива `from_arr`.
- * @param to_arr: массив, куда будет записан результат сбора на процессе
- * `to_rank`.
- * @param to_arr_len: количество элементов в массиве `to_arr`.
- * @param to_arr_datatype: тип данных элементов массива `to_arr`.
- * @param to_rank: ранг процесса результата. По умолчанию 0.
+ * @brief Получает несплошную область по сети MPI без копирования.
+ * @tparam T: тип элементов области.
+ * @param view: область, в которую нужно получить данные.
+ * @param status: статус сообщения.
+ * @param from_rank: ранг отправителя. По умолчанию MPI_ANY_SOURCE.
+ * @param tag: тег сообщения. По умолчанию PARALLEL_STANDARD_TAG.
  * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
  */
 template <typename T>
-inline void Gather(const T *from_arr, int from_arr_len,
-                   MPI_Datatype from_arr_datatype, T *to_arr, int to_arr_len,
-                   MPI_Datatype to_arr_datatype, unsigned int to_rank = 0,
-                   MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
+inline void Receive(View<T> view, MPI_Status &status,
+                    int from_rank = MPI_ANY_SOURCE,
+                    int tag = PARALLEL_STANDARD_TAG,
+                    MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
   if (need_print)
-    std::cout << "parallel::Gather with args: from_arr: " << from_arr_len
-              << "; from_arr_len: " << from_arr_len
-              << "; from_arr_datatype: " << from_arr_datatype
-              << "; to_arr: " << to_arr << "; to_arr_len: " << to_arr_len
-              << "; to_arr_datatype: " << to_arr_datatype
-              << "; to_rank: " << to_rank << "; comm: " << comm;
+    std::cout << "parallel::Receive with args: view: " << view.Data()
+              << "; view_size: " << view.Size() << "; from_rank: " << from_rank
+              << "; tag: " << tag << "; comm: " << comm;
 
-  if (from_arr_len < 0 || to_arr_len < 0)
-    parallel::Error("parallel::Gather: arr_len should be non-negative.");
+  parallel::CheckSuccess(MPI_Recv(view.Data(), 1, view.Datatype(), from_rank,
+                                  tag, comm, &status));
 
-  parallel::CheckSuccess(MPI_Gather(from_arr, from_arr_len, from_arr_datatype,
-                                    to_arr, to_arr_len, to_arr_datatype,
-                                    to_rank, comm));
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Получает несплошную область по сети MPI без копирования.
+ * @tparam T: тип элементов области.
+ * @param view: область, в которую нужно получить данные.
+ * @param from_rank: ранг отправителя. По умолчанию MPI_ANY_SOURCE.
+ * @param tag: тег сообщения. По умолчанию PARALLEL_STANDARD_TAG.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void ReceiveIgnoreStatus(View<T> view, int from_rank = MPI_ANY_SOURCE,
+                                int tag = PARALLEL_STANDARD_TAG,
+                                MPI_Comm comm = MPI_COMM_WORLD,
+                                bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::ReceiveIgnoreStatus with args: view: "
+              << view.Data() << "; view_size: " << view.Size()
+              << "; from_rank: " << from_rank << "; tag: " << tag
+              << "; comm: " << comm;
+
+  parallel::CheckSuccess(MPI_Recv(view.Data(), 1, view.Datatype(), from_rank,
+                                  tag, comm, MPI_STATUS_IGNORE));
 
   if (need_print) std::cout << "SUCCESS" << std::endl;
 }
 
 /**
- * @brief Собирает векторы от всех процессов в сети MPI в одном процессе.
- * @tparam T: тип значения в векторе.
- * @param from_vec: вектор, который будет отправлен от текущего процесса.
- * @param from_vec_datatype: тип данных элементов вектора `from_arr`.
- * @param to_vec: вектор, куда будет записан результат сбора на процессе
- * `to_rank`.
- * @param to_vec_datatype: тип данных элементов вектора `to_arr`.
- * @param to_rank: ранг процесса результата. По умолчанию 0.
+ * @brief Начинает неблокирующее получение несплошной области по сети MPI без
+ * копирования.
+ * @tparam T: тип элементов области.
+ * @param view: область, в которую нужно получить данные (память должна жить
+ * до завершения операции).
+ * @param from_rank: ранг отправителя. По умолчанию MPI_ANY_SOURCE.
+ * @param tag: тег сообщения. По умолчанию PARALLEL_STANDARD_TAG.
  * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ * @return parallel::Request: дескриптор операции.
  */
 template <typename T>
-inline void Gather(const std::vector<T> &from_vec,
-                   MPI_Datatype from_vec_datatype, std::vector<T> &to_vec,
-                   MPI_Datatype to_vec_datatype, unsigned int to_rank = 0,
-                   MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
+inline Request IReceive(View<T> view, int from_rank = MPI_ANY_SOURCE,
+                        int tag = PARALLEL_STANDARD_TAG,
+                        MPI_Comm comm = MPI_COMM_WORLD,
+                        bool need_print = false) {
   if (need_print)
-    std::cout << "parallel::Gather with args: from_vec: " << from_vec
-              << "; from_vec_datatype: " << from_vec_datatype
-              << "; to_vec: " << to_vec
-              << "; to_vec_datatype: " << to_vec_datatype
-              << "; to_rank: " << to_rank << "; comm: " << comm;
+    std::cout << "parallel::IReceive with args: view: " << view.Data()
+              << "; view_size: " << view.Size() << "; from_rank: " << from_rank
+              << "; tag: " << tag << "; comm: " << comm;
+
+  MPI_Request request;
+  parallel::CheckSuccess(MPI_Irecv(view.Data(), 1, view.Datatype(), from_rank,
+                                   tag, comm, &request));
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+
+  return Request(request);
+}
+
+/**
+ * @brief Одновременно отправляет и получает несплошные области по сети MPI
+ * без копирования (например, грани сетки при обмене теневыми ячейками).
+ * @tparam T: тип элементов отправляемой области.
+ * @tparam U: тип элементов получаемой области.
+ * @param send_view: отправляемая область.
+ * @param recv_view: область, в которую нужно получить данные.
+ * @param to_rank: ранг получателя (допускается MPI_PROC_NULL).
+ * @param from_rank: ранг отправителя (допускается MPI_PROC_NULL).
+ * @param tag: тег сообщения. По умолчанию PARALLEL_STANDARD_TAG.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T, typename U>
+inline void SendReceive(View<T> send_view, View<U> recv_view, int to_rank,
+                        int from_rank, int tag = PARALLEL_STANDARD_TAG,
+                        MPI_Comm comm = MPI_COMM_WORLD,
+                        bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::SendReceive with args: send_view: "
+              << send_view.Data() << "; send_view_size: " << send_view.Size()
+              << "; recv_view: " << recv_view.Data()
+              << "; recv_view_size: " << recv_view.Size()
+              << "; to_rank: " << to_rank << "; from_rank: " << from_rank
+              << "; tag: " << tag << "; comm: " << comm;
+
+  parallel::CheckSuccess(MPI_Sendrecv(
+      send_view.Data(), 1, send_view.Datatype(), to_rank, tag, recv_view.Data(),
+      1, recv_view.Datatype(), from_rank, tag, comm, MPI_STATUS_IGNORE));
 
-  if (from_vec.size() > INT_MAX || to_vec.size() > INT_MAX)
-    parallel::Error("parallel::Gather: vector is too big (size > INT_MAX).");
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/**
+ * @brief Рассылает несплошную область от процесса с указанным рангом по сети
+ * MPI без копирования.
+ * @tparam T: тип элементов области.
+ * @param view: рассылаемая область (на остальных процессах - область, куда
+ * будут записаны данные).
+ * @param from_rank: ранг процесса рассылки. По умолчанию 0.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void Broadcast(View<T> view, int from_rank = 0,
+                      MPI_Comm comm = MPI_COMM_WORLD, bool need_print = false) {
+  if (need_print)
+    std::cout << "parallel::Broadcast with args: view: " << view.Data()
+              << "; view_size: " << view.Size() << "; from_rank: " << from_rank
+              << "; comm: " << comm;
 
-  parallel::Gather(from_vec.data(), static_cast<int>(from_vec.size()),
-                   from_vec_datatype, to_vec.data(),
-                   static_cast<int>(to_vec.size()), to_vec_datatype, to_rank,
-                   comm);
+  parallel::CheckSuccess(
+      MPI_Bcast(view.Data(), 1, view.Datatype(), from_rank, comm));
 
   if (need_print) std::cout << "SUCCESS" << std::endl;
 }
 
 /**
- * @brief Собирает массивы от всех процессов в сети MPI в одном процессе с
- * различными размерами для каждого процесса.
- * @tparam T: тип значения в массиве.
- * @param from_arr: массив, который будет отправлен от текущего процесса.
- * @param from_arr_datatype: тип данных элементов массива `from_arr`.
+ * @brief Собирает несплошные области одинакового размера от всех процессов в
+ * сети MPI в сплошной массив на одном процессе без промежуточного копирования.
+ * @tparam T: тип элементов области.
+ * @param from_view: область, которая будет отправлена от текущего процесса.
  * @param to_arr: массив, куда будет записан результат сбора на процессе
- * `to_rank`.
- * @param to_arr_datatype: тип данных элементов массива `to_arr`.
- * @param to_arr_counts: количество значений, которое будет получено от каждого
- * процесса.
- * @param displacements: смещения в массиве `to_arr` для каждого
- * процесса.
- * @param arr_len: количество элементов в массиве `from_arr` и `to_arr`.
+ * `to_rank` (по `from_view.Size()` элементов от каждого процесса).
  * @param to_rank: ранг процесса результата. По умолчанию 0.
  * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
  */
 template <typename T>
-inline void GatherVarious(const T *from_arr, MPI_Datatype from_arr_datatype,
-                          T *to_arr, MPI_Datatype to_arr_datatype,
-                          const int *to_arr_counts, const int *displacements,
-                          int arr_len, unsigned int to_rank = 0,
-                          MPI_Comm comm = MPI_COMM_WORLD,
-                          bool need_print = false) {
+inline void Gather(View<T> from_view, typename std::remove_cv<T>::type *to_arr,
+                   unsigned int to_rank = 0, MPI_Comm comm = MPI_COMM_WORLD,
+                   bool need_print = false) {
   if (need_print)
-    std::cout << "parallel::GatherVarious with args: from_arr: " << from_arr
-              << "; from_arr_datatype: " << from_arr_datatype
-              << "; to_arr: " << to_arr
-              << "; to_arr_datatype: " << to_arr_datatype
-              << "; to_arr_counts: " << to_arr_counts
-              << "; displacements: " << displacements
-              << "; arr_len: " << arr_len << "; to_rank: " << to_rank
+    std::cout << "parallel::Gather with args: from_view: " << from_view.Data()
+              << "; from_view_size: " << from_view.Size()
+              << "; to_arr: " << to_arr << "; to_rank: " << to_rank
               << "; comm: " << comm;
 
-  if (arr_len < 0)
-    parallel::Error("parallel::GatherVarious: arr_len should be non-negative.");
-
-  parallel::CheckSuccess(MPI_Gatherv(from_arr, arr_len, from_arr_datatype,
-                                     to_arr, to_arr_counts, displacements,
-                                     to_arr_datatype, to_rank, comm));
+  parallel::CheckSuccess(
+      MPI_Gather(from_view.Data(), 1, from_view.Datatype(), to_arr,
+                 from_view.Size(),
+                 mpi_type<typename std::remove_cv<T>::type>::get(), to_rank,
+                 comm));
 
   if (need_print) std::cout << "SUCCESS" << std::endl;
 }
 
 /**
- * @brief Собирает векторы от всех процессов в сети MPI в одном процессе с
- * различными размерами для каждого процесса.
- * @tparam T: тип значения в векторе.
- * @param from_vec: вектор, который будет отправлен от текущего процесса.
- * @param from_vec_datatype: тип данных элементов вектора `from_arr`.
- * @param to_vec: вектор, куда будет записан результат сбора на процессе
+ * @brief Собирает несплошные области различного размера от всех процессов в
+ * сети MPI в сплошной массив на одном процессе без промежуточного копирования.
+ * @tparam T: тип элементов области.
+ * @param from_view: область, которая будет отправлена от текущего процесса.
+ * @param to_arr: массив, куда будет записан результат сбора на процессе
  * `to_rank`.
- * @param to_vec_datatype: тип данных элементов вектора `to_arr`.
- * @param to_vec_counts: количество значений, которое будет получено от каждого
- * процесса.
- * @param displacements: смещения в векторе `to_vec` для каждого
+ * @param to_arr_counts: количество значений, которое будет получено от каждого
  * процесса.
+ * @param displacements: смещения в массиве `to_arr` для каждого процесса.
  * @param to_rank: ранг процесса результата. По умолчанию 0.
  * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
  */
 template <typename T>
-inline void GatherVarious(const std::vector<T> &from_vec,
-                          MPI_Datatype from_vec_datatype,
-                          std::vector<T> &to_vec, MPI_Datatype to_vec_datatype,
-                          const std::vector<int> to_vec_counts,
-                          const std::vector<int> displacements,
+inline void GatherVarious(View<T> from_view,
+                          typename std::remove_cv<T>::type *to_arr,
+                          const int *to_arr_counts, const int *displacements,
                           unsigned int to_rank = 0,
                           MPI_Comm comm = MPI_COMM_WORLD,
                           bool need_print = false) {
   if (need_print)
-    std::cout << "parallel::GatherVarious with args: from_vec: " << from_vec
-              << "; from_vec_datatype: " << from_vec_datatype
-              << "; to_vec: " << to_vec
-              << "; to_vec_datatype: " << to_vec_datatype
-              << "; to_vec_counts: " << to_vec_counts
+    std::cout << "parallel::GatherVarious with args: from_view: "
+              << from_view.Data() << "; from_view_size: " << from_view.Size()
+              << "; to_arr: " << to_arr << "; to_arr_counts: " << to_arr_counts
               << "; displacements: " << displacements
               << "; to_rank: " << to_rank << "; comm: " << comm;
 
-  if (from_vec.size() > INT_MAX || to_vec.size() > INT_MAX ||
-      to_vec_counts.size() > INT_MAX || displacements.size() > INT_MAX)
+  parallel::CheckSuccess(
+      MPI_Gatherv(from_view.Data(), 1, from_view.Datatype(), to_arr,
+                  to_arr_counts, displacements,
+                  mpi_type<typename std::remove_cv<T>::type>::get(), to_rank,
+                  comm));
+
+  if (need_print) std::cout << "SUCCESS" << std::endl;
+}
+
+/// @brief формат файла parallel::WriteDistributed.
+enum class FileFormat {
+  Text,   ///< текст: по значению на строку, как VectorToFileWithPrecision
+  Binary  ///< двоичный: байты значений подряд, без заголовка
+};
+
+/**
+ * @brief Коллективно записывает байты процессов в открытый файл MPI-IO
+ * начиная с указанного смещения (MPI_File_write_at_all).
+ * @details Записи длиннее PARALLEL_MAX_COUNT байт делятся на части; число
+ * вызовов одинаково на всех процессах, как того требует коллективная
+ * операция (процессы с более короткой записью пишут пустые части).
+ * @param file: открытый файл MPI.
+ * @param offset: смещение записи процесса в файле (в байтах).
+ * @param bytes: записываемые байты.
+ * @param bytes_len: количество байт.
+ * @param comm: коммуникатор, которым открыт файл.
+ */
+inline void WriteAtAll(MPI_File file, MPI_Offset offset, const char *bytes,
+                       MPI_Offset bytes_len, MPI_Comm comm) {
+  MPI_Offset parts = (bytes_len + PARALLEL_MAX_COUNT - 1) / PARALLEL_MAX_COUNT;
+  parallel::AllOperation(parts, MPI_OFFSET, MPI_MAX, comm);
+
+  for (MPI_Offset part = 0; part < parts; part++) {
+    MPI_Offset begin = Min(part * PARALLEL_MAX_COUNT, bytes_len);
+    MPI_Offset end = Min(begin + PARALLEL_MAX_COUNT, bytes_len);
+
+    parallel::CheckSuccess(MPI_File_write_at_all(
+        file, offset + begin, bytes + begin, static_cast<int>(end - begin),
+        MPI_BYTE, MPI_STATUS_IGNORE));
+  }
+}
+
+/**
+ * @brief Форматирует часть массива для текстового формата
+ * parallel::WriteDistributed: по значению в std::fixed на строку.
+ * @tparam T: арифметический тип значения в массиве.
+ * @param arr: часть массива процесса.
+ * @param arr_len: количество элементов в части.
+ * @param precision: точность значений.
+ * @return std::string: текст части.
+ */
+template <typename T>
+inline typename std::enable_if<std::is_arithmetic<T>::value, std::string>::type
+DistributedText(const T *arr, int arr_len, int precision) {
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(precision);
+
+  for (int i = 0; i < arr_len; i++) out << arr[i] << '\n';
+
+  return out.str();
+}
+
+/**
+ * @brief Текстовый формат для неарифметических типов не определён: такие
+ * массивы записываются только в FileFormat::Binary.
+ */
+template <typename T>
+inline typename std::enable_if<!std::is_arithmetic<T>::value,
+                               std::string>::type
+DistributedText(const T *, int, int) {
+  parallel::Error(
+      "parallel::WriteDistributed: text format needs arithmetic T; use "
+      "FileFormat::Binary.");
+
+  return std::string();
+}
+
+/**
+ * @brief Записывает распределённый по процессам массив в один файл: каждый
+ * процесс пишет свою часть сам, без сбора массива на одном процессе.
+ * @details Части идут в файле по порядку рангов. Смещение части процесса
+ * вычисляется одной операцией parallel::ExclusiveScan над длинами частей
+ * в байтах, после чего все процессы пишут одновременно через
+ * MPI_File_write_at_all. В текстовом формате каждое значение записывается в
+ * std::fixed с точностью precision и переводом строки, поэтому файл
+ * побайтово совпадает с VectorToFileWithPrecision от собранного массива
+ * (строки могут иметь разную длину); он доступен только для арифметических
+ * T. Двоичный формат - представление значений в памяти (подходит и для
+ * структур), точность в нём не используется. Файл перезаписывается.
+ * @tparam T: тип значения в массиве.
+ * @param arr: часть массива процесса (может быть пустой).
+ * @param arr_len: количество элементов в части.
+ * @param file_name: имя файла. По умолчанию "results.txt".
+ * @param format: формат файла. По умолчанию FileFormat::Text.
+ * @param precision: точность в текстовом формате. По умолчанию 6.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void WriteDistributed(const T *arr, int arr_len,
+                             const std::string &file_name = "results.txt",
+                             FileFormat format = FileFormat::Text,
+                             int precision = 6,
+                             MPI_Comm comm = MPI_COMM_WORLD,
+                             bool need_print = false) {
+  static_assert(is_mpi_type<T>::value,
+                "parallel::WriteDistributed: T should be arithmetic or "
+                "trivially copyable struct.");
+
+  if (need_print)
+    std::cout << "parallel::WriteDistributed with args: arr: " << arr
+              << "; arr_len: " << arr_len << "; file_name: " << file_name
+              << "; precision: " << precision << "; comm: " << comm;
+
+  if (arr_len < 0)
     parallel::Error(
-        "parallel::GatherVarious: vector is too big (size > INT_MAX).");
+        "parallel::WriteDistributed: arr_len should be non-negative.");
 
-  parallel::GatherVarious(from_vec.data(), from_vec_datatype, to_vec.data(),
-                          to_vec_datatype, to_vec_counts.data(),
-                          displacements.data(),
-                          Min(static_cast<int>(from_vec.size()), /* */
-                              static_cast<int>(to_vec.size()),
-                              static_cast<int>(to_vec_counts.size()),
-                              static_cast<int>(displacements.size())),
-                          to_rank, comm);
+  std::string text;
+  const char *bytes = reinterpret_cast<const char *>(arr);
+  MPI_Offset bytes_len = static_cast<MPI_Offset>(arr_len) * sizeof(T);
+
+  if (format == FileFormat::Text) {
+    text = parallel::DistributedText(arr, arr_len, precision);
+    bytes = text.data();
+    bytes_len = static_cast<MPI_Offset>(text.size());
+  }
+
+  MPI_Offset offset = 0;
+  parallel::ExclusiveScan(bytes_len, offset, MPI_OFFSET, MPI_SUM, comm);
+
+  MPI_File file;
+  parallel::CheckSuccess(MPI_File_open(comm, file_name.c_str(),
+                                       MPI_MODE_WRONLY | MPI_MODE_CREATE,
+                                       MPI_INFO_NULL, &file));
+
+  // как у std::ofstream: прежнее содержимое файла отбрасывается
+  parallel::CheckSuccess(MPI_File_set_size(file, 0));
+
+  parallel::WriteAtAll(file, offset, bytes, bytes_len, comm);
+
+  parallel::CheckSuccess(MPI_File_close(&file));
 
   if (need_print) std::cout << "SUCCESS" << std::endl;
 }
 
+/**
+ * @brief Записывает распределённый по процессам вектор в один файл (см.
+ * parallel::WriteDistributed для массива).
+ * @tparam T: тип значения в векторе.
+ * @param vec: часть вектора процесса (может быть пустой).
+ * @param file_name: имя файла. По умолчанию "results.txt".
+ * @param format: формат файла. По умолчанию FileFormat::Text.
+ * @param precision: точность в текстовом формате. По умолчанию 6.
+ * @param comm: коммуникатор MPI. По умолчанию MPI_COMM_WORLD.
+ */
+template <typename T>
+inline void WriteDistributed(const std::vector<T> &vec,
+                             const std::string &file_name = "results.txt",
+                             FileFormat format = FileFormat::Text,
+                             int precision = 6,
+                             MPI_Comm comm = MPI_COMM_WORLD,
+                             bool need_print = false) {
+  // запись делится на части сама, ограничена только длина int
+  if (vec.size() > INT_MAX)
+    parallel::Error(
+        "parallel::WriteDistributed: vector is too big (size > INT_MAX).");
+
+  parallel::WriteDistributed(vec.data(), static_cast<int>(vec.size()),
+                             file_name, format, precision, comm, need_print);
+}
+
 }  // namespace parallel
\ No newline at end of file
@@ -3,6 +3,8 @@
 #include <cmath>
 #include <iostream>
 
+#include "reproducible.hpp"
+
 /**
  * @brief Вычисляет значение sqrt(4.0 - x^2)
  * @param x: входной аргумент
@@ -40,6 +42,28 @@ inline double PartOfPi(int N, int start, int end) {
   return part_of_pi;
 }
 
+/**
+ * @brief Вычисляет часть значения числа Пи без ошибок округления суммы
+ * @details Координата каждой части считается от её индекса, а площади
+ * складываются точно, поэтому частичные суммы любых разбиений [0, N)
+ * дают побитово одинаковое число Пи
+ * @param N: количество частей, на которые делится полуокружность
+ * @param start: начальный индекс части
+ * @param end: конечный индекс части (не включая)
+ * @return ReproducibleSum: часть значения числа Пи
+ */
+inline ReproducibleSum ReproduciblePartOfPi(int N, int start, int end) {
+  ReproducibleSum part_of_pi;
+  double seg = 2.0 / N;
+
+  for (int i = start; i < end; i++) {
+    double area = Area(double(i) / N * 2.0, seg);
+    if (std::isfinite(area)) part_of_pi += area;
+  }
+
+  return part_of_pi;
+}
+
 // inline double Pi(int N) { return PartOfPi(N, 0, N); }
 
 /**
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @brief Воспроизводимая сумма чисел double (фиксированная точка)
+ * @details Каждое слагаемое без округления раскладывается по 32-битным
+ * разрядам длинного целого, покрывающего весь диапазон double (от 2^-1074
+ * до 2^1024) с запасом на переполнение. Сумма целых точна, поэтому итог не
+ * зависит ни от порядка сложения, ни от разбиения данных между процессами
+ * или нитями. Тип тривиально копируемый: его можно пересылать через MPI и
+ * сводить операцией parallel::ReproducibleSumOperation()
+ */
+class ReproducibleSum {
+ public:
+  ReproducibleSum() : special_(0.0), pending_(0) {
+    for (int i = 0; i < kLimbs; i++) limbs_[i] = 0;
+  }
+
+  explicit ReproducibleSum(double value) : ReproducibleSum() {
+    *this += value;
+  }
+
+  /**
+   * @brief Точно прибавляет число
+   * @details Бесконечности и NaN складываются отдельно обычным образом
+   * @param value: слагаемое
+   * @return ReproducibleSum&: ссылка на себя
+   */
+  ReproducibleSum& operator+=(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    int biased_exponent = static_cast<int>((bits >> 52) & 0x7FF);
+    uint64_t mantissa = bits & ((uint64_t(1) << 52) - 1);
+
+    if (biased_exponent == 0x7FF) {
+      special_ += value;
+      return *this;
+    }
+
+    // value = mantissa * 2^(bit - 1074); у субнормальных нет скрытой единицы
+    int bit = 0;
+    if (biased_exponent != 0) {
+      mantissa |= uint64_t(1) << 52;
+      bit = biased_exponent - 1;
+    }
+
+    if (mantissa == 0) return *this;
+
+    int limb = bit / 32, shift = bit % 32;
+
+    uint64_t low = (mantissa & ((uint64_t(1) << (32 - shift)) - 1)) << shift;
+    uint64_t high = mantissa >> (32 - shift);
+
+    int64_t parts[3] = {int64_t(low), int64_t(high & kLimbMask),
+                        int64_t(high >> 32)};
+
+    if ((bits >> 63) == 0)
+      for (int i = 0; i < 3; i++) limbs_[limb + i] += parts[i];
+    else
+      for (int i = 0; i < 3; i++) limbs_[limb + i] -= parts[i];
+
+    if (++pending_ == kMaxPending) Normalize();
+
+    return *this;
+  }
+
+  /**
+   * @brief Точно прибавляет другую сумму (порядок слияния не важен)
+   * @param other: другая сумма
+   * @return ReproducibleSum&: ссылка на себя
+   */
+  ReproducibleSum& operator+=(const ReproducibleSum& other) {
+    ReproducibleSum normalized = other;
+    normalized.Normalize();
+    Normalize();
+
+    for (int i = 0; i < kLimbs; i++) limbs_[i] += normalized.limbs_[i];
+    special_ += other.special_;
+
+    Normalize();
+
+    return *this;
+  }
+
+  /**
+   * @brief Округляет накопленную сумму до double
+   * @details Результат однозначно определяется точной суммой, поэтому
+   * одинаков при любом порядке сложения
+   * @return double: значение суммы
+   */
+  double Value() const {
+    if (special_ != 0.0) return special_;  // бесконечность или NaN
+
+    ReproducibleSum magnitude = *this;
+    magnitude.Normalize();
+
+    bool is_negative = magnitude.limbs_[kLimbs - 1] < 0;
+
+    if (is_negative) {
+      for (int i = 0; i < kLimbs; i++)
+        magnitude.limbs_[i] = -magnitude.limbs_[i];
+      magnitude.Normalize();
+    }
+
+    // от младших разрядов к старшим: каждый разряд * 2^k представим точно
+    double value = 0.0;
+    for (int i = 0; i < kLimbs; i++)
+      if (magnitude.limbs_[i] != 0)
+        value += std::ldexp(double(magnitude.limbs_[i]),
+                            32 * i - kMinExponent);
+
+    return is_negative ? -value : value;
+  }
+
+ private:
+  /// @brief показатель младшего бита субнормального double
+  static const int kMinExponent = 1074;
+  /// @brief число 32-битных разрядов: 2098 бит double + запас на перенос
+  static const int kLimbs = 68;
+  /// @brief сколько слагаемых разряд int64 вмещает без переполнения
+  static const int kMaxPending = 1 << 30;
+  static const uint64_t kLimbMask = 0xFFFFFFFFu;
+
+  /**
+   * @brief Переносит излишки разрядов в старшие (канонический вид)
+   * @details После переноса все разряды, кроме старшего, лежат в
+   * [0, 2^32), старший хранит знак
+   */
+  void Normalize() {
+    for (int i = 0; i < kLimbs - 1; i++) {
+      int64_t carry = limbs_[i] >> 32;  // арифметический сдвиг: floor
+      limbs_[i] -= carry * (int64_t(1) << 32);
+      limbs_[i + 1] += carry;
+    }
+
+    pending_ = 0;
+  }
+
+  int64_t limbs_[kLimbs];
+  double special_;
+  int pending_;
+};
+
+#ifdef _OPENMP
+// слияние частичных сумм нитей: reduction(reproducible_sum : sum)
+#pragma omp declare reduction(reproducible_sum : ReproducibleSum : \
+                                  omp_out += omp_in)
+#endif